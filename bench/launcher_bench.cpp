@@ -0,0 +1,350 @@
+// Benchmarks for the launcher's hot paths. Results are printed and written as JSON so runs can be diffed
+// across commits: make bench BENCH_OUT=before.json, then compare with the next run.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/vfs.h>
+#include <unistd.h>
+#endif
+
+#include <SDL.h>
+#include "../src/nlohmann/json.hpp"
+#include "../src/batch_stat.h"
+#include "../src/config_migration.h"
+#include "../src/fire.h"
+#include "../src/launch_utils.h"
+#include "../src/pwad_scan.h"
+#include "../src/task_scheduler.h"
+
+namespace fs = std::filesystem;
+
+static const std::string bench_root = "/tmp/just_launch_doom_bench";
+
+// Keeps the optimizer from dropping work whose result is otherwise unused
+static volatile size_t sink = 0;
+
+struct BenchResult
+{
+    std::string name;
+    size_t items = 0; // Work items per iteration, e.g. files scanned
+    std::vector<double> samples_ms;
+};
+
+static nlohmann::json to_json(const BenchResult &result)
+{
+    std::vector<double> sorted = result.samples_ms;
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0.0;
+    for (double sample : sorted)
+    {
+        total += sample;
+    }
+    double mean = total / sorted.size();
+    double median = sorted[sorted.size() / 2];
+
+    return {{"name", result.name},
+            {"items", result.items},
+            {"iterations", sorted.size()},
+            {"mean_ms", mean},
+            {"median_ms", median},
+            {"min_ms", sorted.front()},
+            {"max_ms", sorted.back()},
+            {"ns_per_item", result.items > 0 ? median * 1e6 / result.items : 0.0}};
+}
+
+// Run fn at least min_iterations times and until min_time has passed, one sample per call
+static BenchResult run_bench(const std::string &name, size_t items, const std::function<void()> &fn,
+                             int min_iterations = 5, double min_time_ms = 300.0)
+{
+    BenchResult result;
+    result.name = name;
+    result.items = items;
+
+    fn(); // Warm-up: page cache, allocator, branch predictors
+
+    double elapsed_ms = 0.0;
+    while (static_cast<int>(result.samples_ms.size()) < min_iterations || elapsed_ms < min_time_ms)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        result.samples_ms.push_back(ms);
+        elapsed_ms += ms;
+        if (result.samples_ms.size() >= 10000)
+        {
+            break;
+        }
+    }
+
+    nlohmann::json summary = to_json(result);
+    std::cout << name << ": median " << summary["median_ms"].get<double>() << " ms over "
+              << result.samples_ms.size() << " iterations" << std::endl;
+    return result;
+}
+
+// Evict the page, dentry and inode caches so the next listing goes to the disk. Needs root (writes
+// /proc/sys/vm/drop_caches), and means nothing on tmpfs, which has no disk behind it. Prints why and returns false
+// when it cannot be done.
+static bool drop_caches(const std::string &path)
+{
+#ifdef __linux__
+    struct statfs fs_info;
+    if (statfs(path.c_str(), &fs_info) == 0 && fs_info.f_type == 0x01021994) // TMPFS_MAGIC
+    {
+        std::cout << "cold cache runs skipped: " << path << " is on tmpfs" << std::endl;
+        return false;
+    }
+    sync();
+    std::ofstream drop("/proc/sys/vm/drop_caches");
+    if (drop << "3" << std::endl)
+    {
+        return true;
+    }
+    std::cout << "cold cache runs skipped: /proc/sys/vm/drop_caches is not writable (run as root)" << std::endl;
+    return false;
+#else
+    (void)path;
+    std::cout << "cold cache runs skipped: dropping caches is only implemented on Linux" << std::endl;
+    return false;
+#endif
+}
+
+// Like run_bench, but with no warm-up and the caches dropped before every sample, so each call reads the tree from
+// disk. Returns false, with no result, if the caches cannot be dropped.
+static bool run_cold_bench(const std::string &name, size_t items, const std::string &tree,
+                           const std::function<void()> &fn, int iterations, BenchResult &result)
+{
+    result = BenchResult();
+    result.name = name;
+    result.items = items;
+    for (int i = 0; i < iterations; i++)
+    {
+        if (!drop_caches(tree))
+        {
+            return false;
+        }
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        result.samples_ms.push_back(
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    nlohmann::json summary = to_json(result);
+    std::cout << name << ": median " << summary["median_ms"].get<double>() << " ms over "
+              << result.samples_ms.size() << " cold iterations" << std::endl;
+    return true;
+}
+
+// Spread file_count files over 10 directories with the mix a real PWAD folder has
+static std::vector<std::string> make_pwad_tree(size_t file_count)
+{
+    const std::string root = bench_root + "/tree_" + std::to_string(file_count);
+    const std::string marker = root + "/.complete";
+    const size_t directory_count = 10;
+    std::vector<std::string> directories;
+    for (size_t d = 0; d < directory_count; d++)
+    {
+        directories.push_back(root + "/dir" + std::to_string(d));
+    }
+    if (fs::exists(marker))
+    {
+        return directories;
+    }
+
+    fs::remove_all(root);
+    const char *extensions[] = {".wad", ".pk3", ".deh", ".txt", ".zip", ".png", ".WAD", ".edf"};
+    for (size_t i = 0; i < file_count; i++)
+    {
+        const std::string &directory = directories[i % directory_count];
+        if (i < directory_count)
+        {
+            fs::create_directories(directory);
+        }
+        std::string stem = directory + "/map" + std::to_string(i);
+        std::ofstream(stem + extensions[i % 8]);
+        if (i % 8 == 0)
+        {
+            std::ofstream(stem + ".txt"); // Companion text file for some WADs
+        }
+    }
+    std::ofstream(marker).put('\n');
+    return directories;
+}
+
+static std::vector<std::string> make_paths(size_t count)
+{
+    const char *extensions[] = {".wad", ".pk3", ".deh", ".bex", ".edf", ".WAD", ".txt", ".zip"};
+    std::vector<std::string> paths;
+    paths.reserve(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        // Repeat file names across directories so build_display_names has to disambiguate
+        paths.push_back("/home/doomer/wads/collection" + std::to_string(i % 37) + "/episode" + std::to_string(i % 101) +
+                        "/map" + std::to_string(i / 3) + extensions[i % 8]);
+    }
+    return paths;
+}
+
+static nlohmann::json make_large_config(size_t entries)
+{
+    nlohmann::json config;
+    config["gzdoom_filepath"] = "/usr/bin/gzdoom";
+    config["iwad_filepath"] = "/home/doomer/iwads/doom2.wad";
+    config["pwad_path"] = "/home/doomer/wads";
+    config["iwads"] = nlohmann::json::array();
+    config["doom_executables"] = nlohmann::json::array();
+    config["selected_pwads"] = nlohmann::json::array();
+    config["pwad_directories"] = nlohmann::json::array();
+    for (size_t i = 0; i < entries; i++)
+    {
+        config["iwads"].push_back("/home/doomer/iwads/iwad" + std::to_string(i) + ".wad");
+        config["doom_executables"].push_back("/opt/ports/port" + std::to_string(i));
+        config["selected_pwads"].push_back("/home/doomer/wads/pwad" + std::to_string(i) + ".wad");
+        config["pwad_directories"].push_back("/home/doomer/wads/dir" + std::to_string(i));
+    }
+    return config;
+}
+
+int main(int argc, char **argv)
+{
+    std::string output_path = argc > 1 ? argv[1] : "bench.json";
+    std::vector<BenchResult> results;
+
+    // The launcher's populate_pwad_list() is this scan followed by an in-memory sort
+    for (size_t file_count : {1000, 10000, 100000})
+    {
+        std::vector<std::string> directories = make_pwad_tree(file_count);
+        results.push_back(run_bench("scan_pwad_directories/" + std::to_string(file_count), file_count, [&]
+                                    { sink += scan_pwad_directories(directories).size(); }, 3));
+
+        // Listing backends head to head; Auto above is getdents on Linux
+        results.push_back(run_bench("scan_backend_std_filesystem/" + std::to_string(file_count), file_count, [&]
+                                    { sink += scan_pwad_directories(directories, PwadScanOptions{PwadScanBackend::StdFilesystem}).size(); }, 3));
+        results.push_back(run_bench("scan_backend_getdents/" + std::to_string(file_count), file_count, [&]
+                                    { sink += scan_pwad_directories(directories, PwadScanOptions{PwadScanBackend::Getdents}).size(); }, 3));
+
+        // And on a cold cache, where the listing waits on the disk
+        if (file_count == 100000)
+        {
+            std::string tree = fs::path(directories.front()).parent_path().string();
+            BenchResult cold;
+            if (run_cold_bench("scan_backend_std_filesystem_cold/" + std::to_string(file_count), file_count, tree, [&]
+                               { sink += scan_pwad_directories(directories, PwadScanOptions{PwadScanBackend::StdFilesystem}).size(); }, 3, cold))
+            {
+                results.push_back(cold);
+                if (run_cold_bench("scan_backend_getdents_cold/" + std::to_string(file_count), file_count, tree, [&]
+                                   { sink += scan_pwad_directories(directories, PwadScanOptions{PwadScanBackend::Getdents}).size(); }, 3, cold))
+                {
+                    results.push_back(cold);
+                }
+            }
+        }
+
+        // The same tree registered once at its top, with the ten folders scanned as concurrent subtrees
+        PwadScanRoot root;
+        root.directory = fs::path(directories.front()).parent_path().string();
+        root.recursive = true;
+        results.push_back(run_bench("scan_pwad_roots_recursive/" + std::to_string(file_count), file_count, [&]
+                                    { sink += scan_pwad_roots({root}).size(); }, 3));
+
+        // Size and date collection after the listing: io_uring statx batches against blocking stat workers
+        std::vector<std::string> paths;
+        PwadList listed = scan_pwad_directories(directories);
+        for (size_t i = 0; i < listed.size(); i++)
+        {
+            paths.emplace_back(listed.filepath(i));
+        }
+        results.push_back(run_bench("batch_stat_io_uring/" + std::to_string(file_count), file_count, [&]
+                                    { sink += batch_stat(paths, 256, BatchStatBackend::IoUring).size(); }, 3));
+        results.push_back(run_bench("batch_stat_thread_pool/" + std::to_string(file_count), file_count, [&]
+                                    { sink += batch_stat(paths, 256, BatchStatBackend::ThreadPool).size(); }, 3));
+    }
+
+    for (size_t count : {10, 100, 1000})
+    {
+        std::vector<std::string> paths = make_paths(count);
+        results.push_back(run_bench("build_launch_file_args/" + std::to_string(count), count, [&]
+                                    { sink += build_launch_file_args(paths).size(); }));
+        results.push_back(run_bench("build_display_names/" + std::to_string(count), count, [&]
+                                    { sink += build_display_names(paths).size(); }));
+    }
+
+    {
+        std::vector<std::string> paths = make_paths(10000);
+        results.push_back(run_bench("has_extension/10000", paths.size(), [&]
+                                    {
+                                        for (const auto &path : paths)
+                                        {
+                                            sink += has_extension(path, WAD_EXTENSIONS);
+                                        } }));
+    }
+
+    for (size_t entries : {100, 1000, 10000})
+    {
+        nlohmann::json config = make_large_config(entries);
+        results.push_back(run_bench("migrate_config/" + std::to_string(entries), entries, [&]
+                                    { sink += migrate_config(config).size(); }));
+    }
+
+    {
+        // Scheduler overhead per task: submitted from outside the pool, and spawned by tasks onto their own
+        // worker's deque for the others to steal
+        TaskScheduler scheduler;
+        const size_t task_count = 100000;
+        std::atomic<size_t> counter(0);
+        results.push_back(run_bench("task_scheduler_submit/" + std::to_string(task_count), task_count, [&]
+                                    {
+                                        for (size_t i = 0; i < task_count; i++)
+                                        {
+                                            scheduler.submit([&counter] { counter++; });
+                                        }
+                                        scheduler.wait_idle(); }));
+        results.push_back(run_bench("task_scheduler_spawn/" + std::to_string(task_count), task_count, [&]
+                                    {
+                                        for (size_t seed = 0; seed < 100; seed++)
+                                        {
+                                            scheduler.submit([&scheduler, &counter, task_count]
+                                                             {
+                                                                 for (size_t i = 0; i < task_count / 100; i++)
+                                                                 {
+                                                                     scheduler.submit([&counter] { counter++; });
+                                                                 } });
+                                        }
+                                        scheduler.wait_idle(); }));
+        sink += counter;
+    }
+
+    const std::pair<int, int> resolutions[] = {{160, 120}, {320, 240}, {640, 480}, {1280, 720}};
+    for (const auto &resolution : resolutions)
+    {
+        std::vector<uint32_t> color_buffer(resolution.first * resolution.second);
+        results.push_back(run_bench("draw_fire/" + std::to_string(resolution.first) + "x" + std::to_string(resolution.second),
+                                    color_buffer.size(), [&]
+                                    { update_fire(color_buffer.data(), resolution.first, resolution.second); }));
+    }
+
+    nlohmann::json report = {{"benchmarks", nlohmann::json::array()}};
+    for (const auto &result : results)
+    {
+        report["benchmarks"].push_back(to_json(result));
+    }
+
+    std::ofstream file(output_path);
+    if (!file.is_open())
+    {
+        std::cerr << "Could not write " << output_path << std::endl;
+        return 1;
+    }
+    file << report.dump(4) << std::endl;
+    std::cout << "Results written to " << output_path << std::endl;
+    return 0;
+}
@@ -0,0 +1,330 @@
+// Headless render harness: runs the real launcher UI on SDL's dummy video driver with the software renderer,
+// feeds it scripted input and reports per-frame CPU time and heap allocations as JSON.
+// Built with JUST_LAUNCH_DOOM_TRACK_ALLOCATIONS so allocations are also broken down by AllocationScope.
+//
+//   make harness HARNESS_ARGS="--frames 600 --script my_script.txt --pwad-dir /tmp/wads"
+//
+// Script lines are "<frame> <action> [args]", with # comments:
+//   30 move 400 300     mouse to (400, 300)
+//   31 click            left button down now, up on the next frame
+//   40 wheel -3         scroll down three notches
+//   50 text doom        type into the focused text field
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <SDL.h>
+#include "../src/nlohmann/json.hpp"
+#include "../src/alloc_tracker.h"
+#include "../src/config_utils.h"
+#include "../src/frame_profiler.h"
+
+// From main.cpp, built with JUST_LAUNCH_DOOM_NO_MAIN
+int setup();
+bool process_events();
+void render_frame();
+void clean_up();
+extern SDL_Window *window;
+
+namespace
+{
+    struct ScriptAction
+    {
+        std::string action;
+        int x = 0;
+        int y = 0;
+        std::string text;
+    };
+
+    struct FrameSample
+    {
+        double wall_ms;
+        double cpu_ms;
+        uint64_t allocations;
+        uint64_t bytes;
+        std::vector<ScopeAllocations> scopes;
+    };
+
+    double thread_cpu_ms()
+    {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#else
+        return std::clock() * 1000.0 / CLOCKS_PER_SEC;
+#endif
+    }
+
+    // Default input when no script is given: sweep the mouse over the window and scroll the PWAD list
+    std::multimap<int, ScriptAction> default_script(int frames)
+    {
+        std::multimap<int, ScriptAction> script;
+        for (int frame = 0; frame < frames; frame += 2)
+        {
+            ScriptAction move;
+            move.action = "move";
+            move.x = 20 + (frame * 7) % 760;
+            move.y = 20 + (frame * 3) % 560;
+            script.insert({frame, move});
+            if (frame % 30 == 0)
+            {
+                ScriptAction wheel;
+                wheel.action = "wheel";
+                wheel.y = (frame / 30) % 2 == 0 ? -3 : 3;
+                script.insert({frame, wheel});
+            }
+        }
+        return script;
+    }
+
+    bool load_script(const std::string &path, std::multimap<int, ScriptAction> &script)
+    {
+        std::ifstream file(path);
+        if (!file.is_open())
+        {
+            return false;
+        }
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            line = line.substr(0, line.find('#'));
+            std::istringstream stream(line);
+            int frame;
+            ScriptAction action;
+            if (!(stream >> frame >> action.action))
+            {
+                continue;
+            }
+            if (action.action == "move")
+            {
+                stream >> action.x >> action.y;
+            }
+            else if (action.action == "wheel")
+            {
+                stream >> action.y;
+            }
+            else if (action.action == "text")
+            {
+                std::getline(stream >> std::ws, action.text);
+            }
+            script.insert({frame, action});
+        }
+        return true;
+    }
+
+    void push_mouse_button(Uint32 type)
+    {
+        SDL_Event event = {};
+        event.type = type;
+        event.button.windowID = SDL_GetWindowID(window);
+        event.button.button = SDL_BUTTON_LEFT;
+        event.button.state = type == SDL_MOUSEBUTTONDOWN ? SDL_PRESSED : SDL_RELEASED;
+        event.button.clicks = 1;
+        SDL_PushEvent(&event);
+    }
+
+    void push_action(const ScriptAction &action, std::vector<Uint32> &next_frame_events)
+    {
+        SDL_Event event = {};
+        if (action.action == "move")
+        {
+            event.type = SDL_MOUSEMOTION;
+            event.motion.windowID = SDL_GetWindowID(window);
+            event.motion.x = action.x;
+            event.motion.y = action.y;
+            SDL_PushEvent(&event);
+        }
+        else if (action.action == "click" || action.action == "down")
+        {
+            push_mouse_button(SDL_MOUSEBUTTONDOWN);
+            if (action.action == "click")
+            {
+                next_frame_events.push_back(SDL_MOUSEBUTTONUP);
+            }
+        }
+        else if (action.action == "up")
+        {
+            push_mouse_button(SDL_MOUSEBUTTONUP);
+        }
+        else if (action.action == "wheel")
+        {
+            event.type = SDL_MOUSEWHEEL;
+            event.wheel.windowID = SDL_GetWindowID(window);
+            event.wheel.y = action.y;
+            SDL_PushEvent(&event);
+        }
+        else if (action.action == "text")
+        {
+            event.type = SDL_TEXTINPUT;
+            event.text.windowID = SDL_GetWindowID(window);
+            strncpy(event.text.text, action.text.c_str(), sizeof(event.text.text) - 1);
+            SDL_PushEvent(&event);
+        }
+        else
+        {
+            std::cerr << "Unknown script action: " << action.action << std::endl;
+        }
+    }
+
+    // Config for the throwaway HOME set in main(), so a harness run never touches the user's launcher settings
+    void write_harness_config(const std::string &pwad_dir)
+    {
+        nlohmann::json config = {{"resolution", {800, 600}},
+                                 {"theme", "fire"},
+                                 {"pwad_directories", nlohmann::json::array()}};
+        if (!pwad_dir.empty())
+        {
+            config["pwad_directories"].push_back(pwad_dir);
+        }
+        std::ofstream(get_config_file_path()) << config.dump(4);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int frames = 300;
+    std::string script_path;
+    std::string output_path = "render_harness.json";
+    std::string pwad_dir;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--frames" && i + 1 < argc)
+        {
+            frames = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--script" && i + 1 < argc)
+        {
+            script_path = argv[++i];
+        }
+        else if (arg == "--out" && i + 1 < argc)
+        {
+            output_path = argv[++i];
+        }
+        else if (arg == "--pwad-dir" && i + 1 < argc)
+        {
+            pwad_dir = std::filesystem::absolute(argv[++i]).string();
+        }
+        else
+        {
+            std::cerr << "Usage: render_harness [--frames N] [--script FILE] [--pwad-dir DIR] [--out FILE]" << std::endl;
+            return 2;
+        }
+    }
+
+    std::multimap<int, ScriptAction> script;
+    if (script_path.empty())
+    {
+        script = default_script(frames);
+    }
+    else if (!load_script(script_path, script))
+    {
+        std::cerr << "Could not read script: " << script_path << std::endl;
+        return 1;
+    }
+
+    std::string home = (std::filesystem::temp_directory_path() / "just_launch_doom_harness").string();
+    std::filesystem::remove_all(home);
+    setenv("HOME", home.c_str(), 1);
+    write_harness_config(pwad_dir);
+    setenv("SDL_VIDEODRIVER", "dummy", 1);
+    setenv("SDL_RENDER_DRIVER", "software", 1);
+
+    if (setup() != 0)
+    {
+        std::cerr << "Setup failed" << std::endl;
+        return 1;
+    }
+
+    std::vector<FrameSample> samples;
+    samples.reserve(frames);
+    std::vector<Uint32> pending_events;
+    for (int frame = 0; frame < frames; frame++)
+    {
+        std::vector<Uint32> next_frame_events;
+        for (Uint32 type : pending_events)
+        {
+            push_mouse_button(type);
+        }
+        auto range = script.equal_range(frame);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            push_action(it->second, next_frame_events);
+        }
+        pending_events = std::move(next_frame_events);
+
+        AllocationCounts allocations_before = get_total_allocations();
+        double cpu_before = thread_cpu_ms();
+        auto wall_before = std::chrono::steady_clock::now();
+
+        bool running = process_events();
+        render_frame();
+
+        samples.push_back({std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wall_before).count(),
+                           thread_cpu_ms() - cpu_before,
+                           get_total_allocations().allocations - allocations_before.allocations,
+                           get_total_allocations().bytes - allocations_before.bytes,
+                           get_last_frame_scope_allocations()});
+        if (!running)
+        {
+            break;
+        }
+    }
+
+    clean_up();
+
+    // The first frames include font atlas upload and startup work, so they are reported but kept out of the summary
+    const size_t warmup = std::min<size_t>(10, samples.size() / 2);
+    std::vector<double> cpu_times;
+    std::vector<double> allocations;
+    nlohmann::json frame_list = nlohmann::json::array();
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        const FrameSample &sample = samples[i];
+        nlohmann::json scopes = nlohmann::json::object();
+        for (const auto &scope : sample.scopes)
+        {
+            scopes[scope.name] = {{"allocations", scope.counts.allocations}, {"bytes", scope.counts.bytes}};
+        }
+        frame_list.push_back({{"frame", i},
+                              {"wall_ms", sample.wall_ms},
+                              {"cpu_ms", sample.cpu_ms},
+                              {"allocations", sample.allocations},
+                              {"bytes", sample.bytes},
+                              {"scopes", scopes}});
+        if (i >= warmup)
+        {
+            cpu_times.push_back(sample.cpu_ms);
+            allocations.push_back(static_cast<double>(sample.allocations));
+        }
+    }
+
+    nlohmann::json report = {{"frames", samples.size()},
+                             {"warmup_frames", warmup},
+                             {"summary",
+                              {{"cpu_ms_p50", percentile(cpu_times, 50.0)},
+                               {"cpu_ms_p95", percentile(cpu_times, 95.0)},
+                               {"cpu_ms_max", percentile(cpu_times, 100.0)},
+                               {"allocations_p50", percentile(allocations, 50.0)},
+                               {"allocations_max", percentile(allocations, 100.0)}}},
+                             {"per_frame", frame_list}};
+
+    std::ofstream file(output_path);
+    file << report.dump(4) << std::endl;
+    std::cout << "cpu p50 " << report["summary"]["cpu_ms_p50"].get<double>() << " ms, p95 "
+              << report["summary"]["cpu_ms_p95"].get<double>() << " ms, allocations/frame p50 "
+              << report["summary"]["allocations_p50"].get<double>() << "; written to " << output_path << std::endl;
+    return 0;
+}
@@ -0,0 +1,231 @@
+#include "alloc_tracker.h"
+
+#ifdef JUST_LAUNCH_DOOM_TRACK_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+namespace
+{
+    const int MAX_SCOPES = 64;
+
+    struct ScopeSlot
+    {
+        std::atomic<const char *> name{nullptr};
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> bytes{0};
+        AllocationCounts last_frame;
+    };
+
+    std::atomic<uint64_t> total_allocations{0};
+    std::atomic<uint64_t> total_bytes{0};
+
+    ScopeSlot scopes[MAX_SCOPES];
+    std::mutex scope_registration_mutex;
+
+    AllocationCounts frame_start;
+    AllocationCounts last_frame;
+
+    // Index into scopes for this thread's innermost AllocationScope, or -1
+    thread_local int current_scope = -1;
+
+    // Fixed table rather than a map, since registering must not allocate from inside the hooks' callers
+    int find_or_register_scope(const char *name)
+    {
+        for (int i = 0; i < MAX_SCOPES; i++)
+        {
+            if (scopes[i].name.load(std::memory_order_acquire) == name)
+            {
+                return i;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(scope_registration_mutex);
+        for (int i = 0; i < MAX_SCOPES; i++)
+        {
+            const char *existing = scopes[i].name.load(std::memory_order_acquire);
+            if (existing == name)
+            {
+                return i;
+            }
+            if (existing == nullptr)
+            {
+                scopes[i].name.store(name, std::memory_order_release);
+                return i;
+            }
+        }
+        return -1; // Table full; allocations in this scope only count towards the totals
+    }
+
+    void record_allocation(std::size_t size)
+    {
+        total_allocations.fetch_add(1, std::memory_order_relaxed);
+        total_bytes.fetch_add(size, std::memory_order_relaxed);
+        if (current_scope >= 0)
+        {
+            scopes[current_scope].allocations.fetch_add(1, std::memory_order_relaxed);
+            scopes[current_scope].bytes.fetch_add(size, std::memory_order_relaxed);
+        }
+    }
+
+    void *tracked_allocate(std::size_t size)
+    {
+        record_allocation(size);
+        if (void *ptr = std::malloc(size ? size : 1))
+        {
+            return ptr;
+        }
+        throw std::bad_alloc();
+    }
+}
+
+void *operator new(std::size_t size)
+{
+    return tracked_allocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return tracked_allocate(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    record_allocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    record_allocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+bool allocation_tracking_available()
+{
+    return true;
+}
+
+AllocationCounts get_total_allocations()
+{
+    AllocationCounts counts;
+    counts.allocations = total_allocations.load(std::memory_order_relaxed);
+    counts.bytes = total_bytes.load(std::memory_order_relaxed);
+    return counts;
+}
+
+void begin_allocation_frame()
+{
+    frame_start = get_total_allocations();
+    for (auto &scope : scopes)
+    {
+        scope.allocations.store(0, std::memory_order_relaxed);
+        scope.bytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+void end_allocation_frame()
+{
+    AllocationCounts now = get_total_allocations();
+    last_frame.allocations = now.allocations - frame_start.allocations;
+    last_frame.bytes = now.bytes - frame_start.bytes;
+    for (auto &scope : scopes)
+    {
+        scope.last_frame.allocations = scope.allocations.load(std::memory_order_relaxed);
+        scope.last_frame.bytes = scope.bytes.load(std::memory_order_relaxed);
+    }
+}
+
+AllocationCounts get_last_frame_allocations()
+{
+    return last_frame;
+}
+
+std::vector<ScopeAllocations> get_last_frame_scope_allocations()
+{
+    std::vector<ScopeAllocations> result;
+    for (const auto &scope : scopes)
+    {
+        const char *name = scope.name.load(std::memory_order_acquire);
+        if (name != nullptr && scope.last_frame.allocations > 0)
+        {
+            result.push_back({name, scope.last_frame});
+        }
+    }
+    return result;
+}
+
+AllocationScope::AllocationScope(const char *name) : previous(current_scope)
+{
+    int index = find_or_register_scope(name);
+    if (index >= 0)
+    {
+        current_scope = index;
+    }
+}
+
+AllocationScope::~AllocationScope()
+{
+    current_scope = previous;
+}
+
+#else
+
+bool allocation_tracking_available()
+{
+    return false;
+}
+
+AllocationCounts get_total_allocations()
+{
+    return {};
+}
+
+void begin_allocation_frame()
+{
+}
+
+void end_allocation_frame()
+{
+}
+
+AllocationCounts get_last_frame_allocations()
+{
+    return {};
+}
+
+std::vector<ScopeAllocations> get_last_frame_scope_allocations()
+{
+    return {};
+}
+
+AllocationScope::AllocationScope(const char *)
+{
+}
+
+AllocationScope::~AllocationScope()
+{
+}
+
+#endif
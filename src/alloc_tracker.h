@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Heap allocation counting for debug builds. Building with JUST_LAUNCH_DOOM_TRACK_ALLOCATIONS
+// (make TRACK_ALLOCATIONS=1) replaces the global operator new/delete; otherwise every call here is a no-op
+// and all counts read as zero.
+
+struct AllocationCounts
+{
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+struct ScopeAllocations
+{
+    const char *name;
+    AllocationCounts counts; // During the last completed frame
+};
+
+// True when the operator new hooks are compiled in
+bool allocation_tracking_available();
+
+// Allocations on any thread since startup
+AllocationCounts get_total_allocations();
+
+// Frame boundaries for the per-frame and per-scope counts
+void begin_allocation_frame();
+void end_allocation_frame();
+AllocationCounts get_last_frame_allocations();
+
+// Scopes that allocated during the last completed frame
+std::vector<ScopeAllocations> get_last_frame_scope_allocations();
+
+// Attributes allocations on this thread to name until destroyed. Nested scopes charge the innermost one.
+// name must be a string literal; scopes are told apart by pointer.
+class AllocationScope
+{
+public:
+    explicit AllocationScope(const char *name);
+    ~AllocationScope();
+
+    AllocationScope(const AllocationScope &) = delete;
+    AllocationScope &operator=(const AllocationScope &) = delete;
+
+#ifdef JUST_LAUNCH_DOOM_TRACK_ALLOCATIONS
+private:
+    int previous;
+#endif
+};
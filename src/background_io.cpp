@@ -0,0 +1,205 @@
+#include "background_io.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    struct JobRecord
+    {
+        std::string name;
+        std::chrono::steady_clock::time_point started;
+        BackgroundIoMode mode = BackgroundIoMode::Normal;
+        bool waiting = false;
+    };
+
+    std::atomic<BackgroundIoMode> current_mode(BackgroundIoMode::Normal);
+    std::atomic<std::thread::id> ui_thread;
+
+    std::mutex jobs_mutex;
+    std::condition_variable resume_cv;
+    std::map<uint64_t, JobRecord> jobs;
+    uint64_t next_job_id = 1;
+
+    thread_local BackgroundIoMode thread_mode = BackgroundIoMode::Normal;
+    thread_local uint64_t thread_job = 0;
+
+#ifdef __linux__
+    // From linux/ioprio.h, which older distributions do not ship
+    const int IOPRIO_CLASS_SHIFT = 13;
+    const int IOPRIO_CLASS_IDLE = 3;
+    const int IOPRIO_WHO_PROCESS = 1;
+
+    thread_local bool lowered_cpu = false;
+    thread_local bool lowered_with_nice = false;
+    thread_local int saved_ioprio = 0;
+    thread_local int saved_nice = 0;
+
+    // Leaving SCHED_IDLE or lowering nice again needs CAP_SYS_NICE or an RLIMIT_NICE that allows nice 0. Without
+    // either, a lowered worker would stay slow for the rest of the session, so only its I/O class is changed.
+    bool can_restore_cpu_priority()
+    {
+        struct rlimit limit;
+        return geteuid() == 0 ||
+               (getrlimit(RLIMIT_NICE, &limit) == 0 && (limit.rlim_cur == RLIM_INFINITY || limit.rlim_cur >= 20));
+    }
+#endif
+
+    // Lower or restore the calling thread's I/O and CPU priority. Returns false if nothing could be changed.
+    bool set_thread_low_priority(bool low)
+    {
+#ifdef __linux__
+        // pid 0 means the calling thread for ioprio_set and sched_setscheduler alike
+        pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+        if (low)
+        {
+            saved_ioprio = static_cast<int>(syscall(SYS_ioprio_get, IOPRIO_WHO_PROCESS, 0));
+            bool io_ok = syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT) == 0;
+
+            lowered_cpu = false;
+            if (can_restore_cpu_priority())
+            {
+                sched_param param = {};
+                lowered_with_nice = sched_setscheduler(0, SCHED_IDLE, &param) != 0;
+                if (lowered_with_nice)
+                {
+                    saved_nice = getpriority(PRIO_PROCESS, tid);
+                    lowered_cpu = setpriority(PRIO_PROCESS, tid, 19) == 0;
+                }
+                else
+                {
+                    lowered_cpu = true;
+                }
+            }
+            return io_ok || lowered_cpu;
+        }
+
+        bool io_ok = syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, saved_ioprio < 0 ? 0 : saved_ioprio) == 0;
+        bool cpu_ok = true;
+        if (lowered_cpu)
+        {
+            sched_param param = {};
+            cpu_ok = lowered_with_nice ? setpriority(PRIO_PROCESS, tid, saved_nice) == 0
+                                       : sched_setscheduler(0, SCHED_OTHER, &param) == 0;
+            lowered_cpu = !cpu_ok;
+        }
+        return io_ok && cpu_ok;
+#elif defined(__APPLE__)
+        // Background band: throttled disk I/O and low CPU priority for this thread only
+        return setpriority(PRIO_DARWIN_THREAD, 0, low ? PRIO_DARWIN_BG : 0) == 0;
+#elif defined(_WIN32)
+        return SetThreadPriority(GetCurrentThread(), low ? THREAD_MODE_BACKGROUND_BEGIN : THREAD_MODE_BACKGROUND_END) != 0;
+#else
+        (void)low;
+        return false;
+#endif
+    }
+
+    void update_job(BackgroundIoMode mode, bool waiting)
+    {
+        if (thread_job == 0)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(jobs_mutex);
+        auto it = jobs.find(thread_job);
+        if (it != jobs.end())
+        {
+            it->second.mode = mode;
+            it->second.waiting = waiting;
+        }
+    }
+}
+
+void set_background_io_mode(BackgroundIoMode mode)
+{
+    ui_thread = std::this_thread::get_id();
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex);
+        current_mode = mode;
+    }
+    resume_cv.notify_all();
+}
+
+BackgroundIoMode get_background_io_mode()
+{
+    return current_mode;
+}
+
+void background_io_checkpoint()
+{
+    if (std::this_thread::get_id() == ui_thread.load())
+    {
+        return;
+    }
+
+    BackgroundIoMode mode = current_mode;
+    if (mode == BackgroundIoMode::Suspended)
+    {
+        update_job(thread_mode, true);
+        std::unique_lock<std::mutex> lock(jobs_mutex);
+        resume_cv.wait(lock, []
+                       { return current_mode != BackgroundIoMode::Suspended; });
+        mode = current_mode;
+        lock.unlock();
+        update_job(thread_mode, false);
+    }
+
+    bool want_low = mode == BackgroundIoMode::LowPriority;
+    bool is_low = thread_mode == BackgroundIoMode::LowPriority;
+    if (want_low != is_low && set_thread_low_priority(want_low))
+    {
+        thread_mode = want_low ? BackgroundIoMode::LowPriority : BackgroundIoMode::Normal;
+        update_job(thread_mode, false);
+    }
+}
+
+BackgroundJob::BackgroundJob(const char *name) : outer_id_(thread_job)
+{
+    std::lock_guard<std::mutex> lock(jobs_mutex);
+    id_ = next_job_id++;
+    JobRecord &record = jobs[id_];
+    record.name = name;
+    record.started = std::chrono::steady_clock::now();
+    record.mode = thread_mode;
+    thread_job = id_;
+}
+
+BackgroundJob::~BackgroundJob()
+{
+    std::lock_guard<std::mutex> lock(jobs_mutex);
+    jobs.erase(id_);
+    thread_job = outer_id_;
+}
+
+std::vector<BackgroundJobStatus> get_background_jobs()
+{
+    std::vector<BackgroundJobStatus> result;
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(jobs_mutex);
+    for (const auto &[id, record] : jobs)
+    {
+        BackgroundJobStatus status;
+        status.name = record.name;
+        status.seconds = std::chrono::duration<double>(now - record.started).count();
+        status.mode = record.mode;
+        status.waiting = record.waiting;
+        result.push_back(std::move(status));
+    }
+    return result;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// How the launcher's worker threads use the disk and CPU, switched while a launched game is running
+enum class BackgroundIoMode
+{
+    Normal,
+    LowPriority, // Idle I/O class, plus SCHED_IDLE (or nice 19) where that can be undone afterwards
+    Suspended    // Workers wait at their next checkpoint until the mode changes
+};
+
+// Called from the UI thread. Workers pick the change up at their next checkpoint; checkpoints on the UI thread
+// itself never throttle or block.
+void set_background_io_mode(BackgroundIoMode mode);
+BackgroundIoMode get_background_io_mode();
+
+// Called by worker threads between units of work (a directory listed, a file prefetched). Brings the calling
+// thread's priority in line with the current mode and blocks while workers are suspended.
+void background_io_checkpoint();
+
+// Registers the calling thread's work in the jobs panel for the lifetime of the object
+class BackgroundJob
+{
+public:
+    explicit BackgroundJob(const char *name);
+    ~BackgroundJob();
+    BackgroundJob(const BackgroundJob &) = delete;
+    BackgroundJob &operator=(const BackgroundJob &) = delete;
+
+private:
+    uint64_t id_;
+    uint64_t outer_id_; // Job this one is nested in on the same thread, if any
+};
+
+struct BackgroundJobStatus
+{
+    std::string name;
+    double seconds = 0.0;                        // Since the job started
+    BackgroundIoMode mode = BackgroundIoMode::Normal; // What the job's thread last switched to
+    bool waiting = false;                        // Blocked at a checkpoint while suspended
+};
+
+std::vector<BackgroundJobStatus> get_background_jobs();
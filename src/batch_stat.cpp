@@ -0,0 +1,310 @@
+#include "batch_stat.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    FileMetadata stat_one(const std::string &path)
+    {
+        FileMetadata metadata;
+        struct stat st;
+        if (stat(path.c_str(), &st) == 0)
+        {
+            metadata.ok = true;
+            metadata.size = static_cast<uint64_t>(st.st_size);
+            metadata.mtime = static_cast<int64_t>(st.st_mtime);
+        }
+        return metadata;
+    }
+
+    void batch_stat_threads(const std::vector<std::string> &paths, size_t max_in_flight, std::vector<FileMetadata> &results)
+    {
+        // Each worker has one blocking stat outstanding, so the thread count is the number in flight
+        const size_t max_threads = 64;
+        size_t thread_count = std::min({max_in_flight, paths.size(), max_threads});
+        std::atomic<size_t> next(0);
+        auto worker = [&]()
+        {
+            for (size_t i = next++; i < paths.size(); i = next++)
+            {
+                results[i] = stat_one(paths[i]);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < thread_count; i++)
+        {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+#ifdef __linux__
+    // Minimal io_uring over raw syscalls: just enough to submit IORING_OP_STATX and reap completions
+    class StatxRing
+    {
+    public:
+        explicit StatxRing(unsigned entries)
+        {
+            io_uring_params params;
+            memset(&params, 0, sizeof(params));
+            fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+            if (fd_ < 0)
+            {
+                return;
+            }
+
+            sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single_mmap)
+            {
+                sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+            }
+
+            sq_ring_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+            cq_ring_ = single_mmap ? sq_ring_
+                                   : mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+            sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+            sqes_ = static_cast<io_uring_sqe *>(
+                mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES));
+            if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED)
+            {
+                release();
+                return;
+            }
+
+            char *sq = static_cast<char *>(sq_ring_);
+            sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+            sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+            sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+            char *cq = static_cast<char *>(cq_ring_);
+            cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+            cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+            cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+            cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+            capacity_ = params.sq_entries;
+        }
+
+        ~StatxRing() { release(); }
+        StatxRing(const StatxRing &) = delete;
+        StatxRing &operator=(const StatxRing &) = delete;
+
+        bool ok() const { return fd_ >= 0 && capacity_ > 0; }
+        unsigned capacity() const { return capacity_; }
+
+        // Queue a statx; buffer and path must stay alive until the completion is reaped
+        void queue_statx(const char *path, struct statx *buffer, uint64_t user_data)
+        {
+            unsigned tail = *sq_tail_;
+            unsigned index = tail & sq_mask_;
+            io_uring_sqe *sqe = &sqes_[index];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = IORING_OP_STATX;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = reinterpret_cast<uint64_t>(path);
+            sqe->len = STATX_SIZE | STATX_MTIME;
+            sqe->off = reinterpret_cast<uint64_t>(buffer);
+            sqe->statx_flags = AT_STATX_SYNC_AS_STAT;
+            sqe->user_data = user_data;
+            sq_array_[index] = index;
+            __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+            queued_++;
+        }
+
+        // Submit everything queued and wait for at least min_complete completions
+        bool submit_and_wait(unsigned min_complete)
+        {
+            while (true)
+            {
+                long submitted = syscall(__NR_io_uring_enter, fd_, queued_, min_complete, IORING_ENTER_GETEVENTS, nullptr, 0);
+                if (submitted >= 0)
+                {
+                    queued_ -= static_cast<unsigned>(submitted);
+                    return true;
+                }
+                if (errno != EINTR)
+                {
+                    return false;
+                }
+            }
+        }
+
+        // Call fn(user_data, result) for every completion that has arrived
+        template <typename Fn>
+        unsigned reap(Fn fn)
+        {
+            unsigned head = *cq_head_;
+            unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+            unsigned count = 0;
+            for (; head != tail; head++, count++)
+            {
+                const io_uring_cqe &cqe = cqes_[head & cq_mask_];
+                fn(cqe.user_data, cqe.res);
+            }
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+            return count;
+        }
+
+    private:
+        void release()
+        {
+            if (sqes_ && sqes_ != MAP_FAILED)
+            {
+                munmap(sqes_, sqes_size_);
+            }
+            if (cq_ring_ && cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_)
+            {
+                munmap(cq_ring_, cq_size_);
+            }
+            if (sq_ring_ && sq_ring_ != MAP_FAILED)
+            {
+                munmap(sq_ring_, sq_size_);
+            }
+            if (fd_ >= 0)
+            {
+                close(fd_);
+            }
+            sqes_ = nullptr;
+            sq_ring_ = cq_ring_ = nullptr;
+            fd_ = -1;
+            capacity_ = 0;
+        }
+
+        int fd_ = -1;
+        void *sq_ring_ = nullptr;
+        void *cq_ring_ = nullptr;
+        size_t sq_size_ = 0;
+        size_t cq_size_ = 0;
+        size_t sqes_size_ = 0;
+        io_uring_sqe *sqes_ = nullptr;
+        unsigned *sq_tail_ = nullptr;
+        unsigned sq_mask_ = 0;
+        unsigned *sq_array_ = nullptr;
+        unsigned *cq_head_ = nullptr;
+        unsigned *cq_tail_ = nullptr;
+        unsigned cq_mask_ = 0;
+        io_uring_cqe *cqes_ = nullptr;
+        unsigned capacity_ = 0;
+        unsigned queued_ = 0;
+    };
+
+    // Returns false if io_uring could not be used at all; individual failed requests fall back to stat()
+    bool batch_stat_io_uring(const std::vector<std::string> &paths, size_t max_in_flight, std::vector<FileMetadata> &results)
+    {
+        unsigned entries = static_cast<unsigned>(std::clamp<size_t>(max_in_flight, 1, 4096));
+        // One statx buffer per ring slot; a slot is reused once its completion is reaped. Declared before the ring so
+        // they outlive it: requests still in flight when the ring is torn down may write into them.
+        std::vector<struct statx> buffers(entries);
+        std::vector<size_t> slot_path(entries);
+        StatxRing ring(entries);
+        if (!ring.ok())
+        {
+            return false;
+        }
+
+        unsigned slots = std::min<unsigned>(ring.capacity(), entries);
+        std::vector<unsigned> free_slots;
+        for (unsigned slot = slots; slot > 0; slot--)
+        {
+            free_slots.push_back(slot - 1);
+        }
+
+        size_t next = 0;
+        size_t in_flight = 0;
+        while (next < paths.size() || in_flight > 0)
+        {
+            while (next < paths.size() && !free_slots.empty())
+            {
+                unsigned slot = free_slots.back();
+                free_slots.pop_back();
+                slot_path[slot] = next;
+                ring.queue_statx(paths[next].c_str(), &buffers[slot], slot);
+                next++;
+                in_flight++;
+            }
+
+            if (!ring.submit_and_wait(1))
+            {
+                // The ring broke mid-batch; finish the rest with plain stat calls
+                for (unsigned slot = 0; slot < slots; slot++)
+                {
+                    if (std::find(free_slots.begin(), free_slots.end(), slot) == free_slots.end())
+                    {
+                        results[slot_path[slot]] = stat_one(paths[slot_path[slot]]);
+                    }
+                }
+                for (; next < paths.size(); next++)
+                {
+                    results[next] = stat_one(paths[next]);
+                }
+                return true;
+            }
+
+            in_flight -= ring.reap([&](uint64_t user_data, int result)
+                                   {
+                                       unsigned slot = static_cast<unsigned>(user_data);
+                                       size_t path_index = slot_path[slot];
+                                       if (result == 0)
+                                       {
+                                           results[path_index].ok = true;
+                                           results[path_index].size = buffers[slot].stx_size;
+                                           results[path_index].mtime = buffers[slot].stx_mtime.tv_sec;
+                                       }
+                                       else if (result == -EINVAL || result == -EOPNOTSUPP)
+                                       {
+                                           // Kernel without IORING_OP_STATX
+                                           results[path_index] = stat_one(paths[path_index]);
+                                       }
+                                       free_slots.push_back(slot); });
+        }
+        return true;
+    }
+#endif
+}
+
+bool io_uring_available()
+{
+#ifdef __linux__
+    static const bool available = StatxRing(1).ok();
+    return available;
+#else
+    return false;
+#endif
+}
+
+std::vector<FileMetadata> batch_stat(const std::vector<std::string> &paths, size_t max_in_flight, BatchStatBackend backend)
+{
+    std::vector<FileMetadata> results(paths.size());
+    if (paths.empty())
+    {
+        return results;
+    }
+    max_in_flight = std::max<size_t>(1, max_in_flight);
+
+#ifdef __linux__
+    if (backend == BatchStatBackend::IoUring && io_uring_available() &&
+        batch_stat_io_uring(paths, max_in_flight, results))
+    {
+        return results;
+    }
+#endif
+    batch_stat_threads(paths, max_in_flight, results);
+    return results;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct FileMetadata
+{
+    bool ok = false;     // False if the file could not be stat'ed
+    uint64_t size = 0;   // Bytes
+    int64_t mtime = 0;   // Seconds since the epoch
+};
+
+enum class BatchStatBackend
+{
+    ThreadPool, // Blocking stat calls spread over worker threads. Faster on local disks, where stat is a cache hit.
+    IoUring     // Linux only; falls back to the thread pool if io_uring cannot be set up. Pays off on network
+                // mounts, where every stat is a round trip to overlap.
+};
+
+// True if an io_uring instance can be created here (Linux 5.6+, not blocked by seccomp)
+bool io_uring_available();
+
+// Stat every path, keeping up to max_in_flight requests outstanding at once. On network filesystems each stat is a
+// round trip, so overlapping them is what makes metadata collection fast. Results are in input order.
+std::vector<FileMetadata> batch_stat(const std::vector<std::string> &paths, size_t max_in_flight = 256,
+                                     BatchStatBackend backend = BatchStatBackend::ThreadPool);
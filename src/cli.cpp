@@ -0,0 +1,180 @@
+#include "cli.h"
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "config_migration.h"
+#include "config_utils.h"
+#include "launch_utils.h"
+#include "launch_validation.h"
+#include "profile_utils.h"
+#include "trace.h"
+
+#ifndef _WIN32
+#include <cstdio>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char *USAGE =
+        "Usage: just_launch_doom [--launch] [--profile NAME] [--print-command] [--trace PATH]\n"
+        "\n"
+        "With no arguments the launcher window opens as usual.\n"
+        "\n"
+        "  --launch          Start the selected game directly, without opening a window\n"
+        "  --profile NAME    Use the saved profile NAME instead of the current selection\n"
+        "  --print-command   Print the launch command (without --launch, nothing is started)\n"
+        "  --trace PATH      Record a trace of launcher activity to PATH (open in Perfetto or about://tracing)\n"
+        "  --help            Show this message\n";
+}
+
+CliOptions parse_cli_args(int argc, char **argv)
+{
+    CliOptions options;
+    std::vector<std::string> unknown;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--launch")
+        {
+            options.launch = true;
+        }
+        else if (arg == "--print-command")
+        {
+            options.print_command = true;
+        }
+        else if (arg == "--help" || arg == "-h")
+        {
+            options.help = true;
+        }
+        else if (arg == "--profile")
+        {
+            if (i + 1 >= argc)
+            {
+                options.error = "--profile requires a profile name";
+                return options;
+            }
+            options.profile = argv[++i];
+        }
+        else if (arg.rfind("--profile=", 0) == 0)
+        {
+            options.profile = arg.substr(std::string("--profile=").length());
+        }
+        else if (arg == "--trace")
+        {
+            if (i + 1 >= argc)
+            {
+                options.error = "--trace requires an output path";
+                return options;
+            }
+            options.trace = argv[++i];
+        }
+        else if (arg.rfind("--trace=", 0) == 0)
+        {
+            options.trace = arg.substr(std::string("--trace=").length());
+        }
+        else
+        {
+            // Platforms may pass their own arguments to GUI apps, so these only matter in headless mode
+            unknown.push_back(arg);
+        }
+    }
+
+    if ((options.launch || options.print_command) && !unknown.empty())
+    {
+        options.error = "Unknown option: " + unknown.front();
+    }
+    return options;
+}
+
+bool is_headless_run(const CliOptions &options)
+{
+    return options.launch || options.print_command || options.help || !options.error.empty();
+}
+
+int run_headless(const CliOptions &options)
+{
+    if (!options.error.empty())
+    {
+        std::cerr << options.error << "\n\n"
+                  << USAGE;
+        return 2;
+    }
+    if (options.help)
+    {
+        std::cout << USAGE;
+        return 0;
+    }
+
+    std::string config_file_path = get_config_file_path();
+    nlohmann::json config;
+    if (!read_config_file(config_file_path, config))
+    {
+        std::cerr << "Could not read config file: " << config_file_path << std::endl;
+        return 1;
+    }
+    {
+        TraceScope trace("migrate_config");
+        config = migrate_config(config);
+    }
+
+    if (!options.profile.empty() && !apply_profile(config, options.profile))
+    {
+        std::cerr << "Unknown profile: " << options.profile << std::endl;
+        return 1;
+    }
+    normalize_launch_config(config);
+
+    std::string command = build_launch_command(config);
+    if (options.print_command)
+    {
+        std::cout << command << std::endl;
+    }
+    if (!options.launch)
+    {
+        return 0;
+    }
+
+    if (config.value("selected_executable", "").empty())
+    {
+        std::cerr << "No Doom executable selected" << std::endl;
+        return 1;
+    }
+
+    std::vector<LaunchFileIssue> issues = validate_launch_files(get_selected_file_paths(config));
+    if (!issues.empty())
+    {
+        for (const auto &issue : issues)
+        {
+            std::cerr << describe_launch_file_problem(issue.problem) << ": " << issue.path << std::endl;
+        }
+        return 1;
+    }
+
+    // Match the renderer the launcher window would have passed on (fix for issue #16)
+    std::string renderer_setting = config.value("sdl_renderer", "auto");
+    if (renderer_setting != "auto" && config.value("sdl_renderer_inherit", false))
+    {
+        static std::string env_var;
+        env_var = "SDL_RENDER_DRIVER=" + renderer_setting;
+#ifdef _WIN32
+        _putenv(env_var.c_str());
+#else
+        putenv(const_cast<char *>(env_var.c_str()));
+#endif
+    }
+
+#ifdef _WIN32
+    launch_process_win(command.c_str());
+    return 0;
+#else
+    // Replace the launcher process with the shell running the port, so nothing of the launcher stays resident
+    stop_trace();
+    execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char *>(nullptr));
+    perror("Failed to start the source port");
+    return 1;
+#endif
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <string>
+
+struct CliOptions
+{
+    bool launch = false;        // --launch: start the game without opening the launcher window
+    bool print_command = false; // --print-command: print the launch command to stdout
+    bool help = false;          // --help
+    std::string profile;        // --profile NAME: apply a saved profile before building the command
+    std::string trace;          // --trace PATH: write a Chrome trace of startup and launcher activity on exit
+    std::string error;          // Set when the arguments could not be parsed
+};
+
+CliOptions parse_cli_args(int argc, char **argv);
+
+// True when the arguments ask for a run without a window, so SDL and ImGui are never initialized
+bool is_headless_run(const CliOptions &options);
+
+// Load the config, build the launch command and exec the source port. Returns the process exit code.
+int run_headless(const CliOptions &options);
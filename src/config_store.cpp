@@ -0,0 +1,94 @@
+#include "config_store.h"
+#include <filesystem>
+#include <fstream>
+#include "trace.h"
+
+const nlohmann::json &ConfigSnapshot::value(const std::string &key) const
+{
+    static const nlohmann::json missing;
+    auto it = values_.find(key);
+    return it != values_.end() ? *it->second : missing;
+}
+
+nlohmann::json ConfigSnapshot::document() const
+{
+    nlohmann::json document = nlohmann::json::object();
+    for (const auto &[key, value] : values_)
+    {
+        document[key] = *value;
+    }
+    return document;
+}
+
+ConfigSnapshotPtr ConfigStore::commit(const nlohmann::json &document)
+{
+    ConfigSnapshotPtr previous = snapshot();
+    auto next = std::make_shared<ConfigSnapshot>();
+    bool changed = !previous;
+    if (document.is_object())
+    {
+        for (auto it = document.begin(); it != document.end(); ++it)
+        {
+            if (previous)
+            {
+                auto found = previous->values_.find(it.key());
+                if (found != previous->values_.end() && *found->second == it.value())
+                {
+                    next->values_.emplace(it.key(), found->second);
+                    continue;
+                }
+            }
+            next->values_.emplace(it.key(), std::make_shared<const nlohmann::json>(it.value()));
+            changed = true;
+        }
+    }
+    if (!changed && next->values_.size() == previous->values_.size())
+    {
+        return previous;
+    }
+
+    next->version_ = previous ? previous->version_ + 1 : 1;
+    ConfigSnapshotPtr published = std::move(next);
+    std::atomic_store(&current_, published);
+    return published;
+}
+
+bool ConfigStore::save(const std::string &path, const ConfigSnapshot &snapshot)
+{
+    TraceScope trace("save_config_snapshot");
+    std::string text = snapshot.document().dump(4);
+
+    std::lock_guard<std::mutex> lock(save_mutex_);
+    if (snapshot.version() <= saved_version_)
+    {
+        return true; // A newer snapshot is already on disk
+    }
+
+    std::error_code ec;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty())
+    {
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary);
+        if (!file.is_open())
+        {
+            return false;
+        }
+        file << text;
+        if (!file.good())
+        {
+            return false;
+        }
+    }
+    std::filesystem::rename(temporary, path, ec);
+    if (ec)
+    {
+        return false;
+    }
+    saved_version_ = snapshot.version();
+    return true;
+}
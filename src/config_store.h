@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "nlohmann/json.hpp"
+
+// The config as of one commit. Immutable, so any thread can read it while the UI goes on editing the working
+// document. Top-level values that did not change are shared with the previous snapshot.
+class ConfigSnapshot
+{
+public:
+    uint64_t version() const { return version_; }
+    // The value stored under key, or null if there is none
+    const nlohmann::json &value(const std::string &key) const;
+    bool contains(const std::string &key) const { return values_.count(key) != 0; }
+    // The whole document, assembled for serialization
+    nlohmann::json document() const;
+
+private:
+    friend class ConfigStore;
+    uint64_t version_ = 0;
+    std::map<std::string, std::shared_ptr<const nlohmann::json>, std::less<>> values_;
+};
+
+using ConfigSnapshotPtr = std::shared_ptr<const ConfigSnapshot>;
+
+// Versioned snapshots of the UI's working config document. The UI thread mutates the document as before and
+// commits it; background work reads and serializes the committed snapshots and never touches the document.
+class ConfigStore
+{
+public:
+    // Publish document as the next snapshot, copying only the top-level values that changed since the last
+    // commit. Returns the current snapshot unchanged if nothing did. UI thread only.
+    ConfigSnapshotPtr commit(const nlohmann::json &document);
+    // The latest committed snapshot, or null before the first commit. Any thread.
+    ConfigSnapshotPtr snapshot() const { return std::atomic_load(&current_); }
+
+    // Write snapshot to path through a temporary file, so a crash never leaves half a config behind. Any thread.
+    // A snapshot older than one already written is skipped, so saves finishing out of order never roll the file
+    // back. Returns false if the file could not be written.
+    bool save(const std::string &path, const ConfigSnapshot &snapshot);
+
+private:
+    ConfigSnapshotPtr current_;
+    std::mutex save_mutex_; // Orders writers; readers and commits never take it
+    uint64_t saved_version_ = 0;
+};
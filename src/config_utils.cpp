@@ -3,6 +3,7 @@
 #include <cassert>
 #include <filesystem>
 #include "nlohmann/json.hpp"
+#include "trace.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -44,6 +45,8 @@ std::string get_config_file_path()
 
 bool write_config_file(const std::string &path, nlohmann::json &config)
 {
+    TraceScope trace("write_config_file");
+
     // Create parent directory if it doesn't exist
     std::filesystem::path file_path(path);
     std::filesystem::path parent_dir = file_path.parent_path();
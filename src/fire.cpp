@@ -38,12 +38,12 @@ void spread_fire(int window_width, int from)
     }
 }
 
-void draw_fire(SDL_Texture* texture, uint32_t *color_buffer, int window_width, int window_height)
+void update_fire(uint32_t *color_buffer, int window_width, int window_height)
 {
-
-    if (fire_pixels.empty())
+    // Restart the fire when the color buffer size changes, e.g. after a window resize
+    if (fire_pixels.size() != (size_t) (window_width * window_height))
     {
-        fire_pixels.resize(window_width * window_height, 0 );
+        fire_pixels.assign(window_width * window_height, 0);
         for (int i = 0; i < window_width * window_height; i++)
         {
             if (i > window_width * (window_height - 1) - window_width)
@@ -63,6 +63,10 @@ void draw_fire(SDL_Texture* texture, uint32_t *color_buffer, int window_width, i
             color_buffer[index] = COLORS[fire_pixels[index]];
         }
     }
+}
 
+void draw_fire(SDL_Texture* texture, uint32_t *color_buffer, int window_width, int window_height)
+{
+    update_fire(color_buffer, window_width, window_height);
     SDL_UpdateTexture(texture, nullptr, color_buffer, (int) (window_width * sizeof(uint32_t)));
 }
\ No newline at end of file
@@ -5,6 +5,9 @@
 #ifndef SDL_IMGUI_FIRE_H
 #define SDL_IMGUI_FIRE_H
 
+// Advance the fire one step into color_buffer without touching SDL
+void update_fire(uint32_t *color_buffer, int window_width, int window_height);
+
 void draw_fire(SDL_Texture* texture, uint32_t *color_buffer, int window_width, int window_height);
 
 #endif //SDL_IMGUI_FIRE_H
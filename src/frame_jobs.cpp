@@ -0,0 +1,27 @@
+#include "frame_jobs.h"
+
+void FrameJobQueue::post(FrameJob job)
+{
+    jobs_.push_back(std::move(job));
+}
+
+size_t FrameJobQueue::run(std::chrono::microseconds budget)
+{
+    if (jobs_.empty())
+    {
+        return 0;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + budget;
+    size_t finished = 0;
+    do
+    {
+        // A slice may post further jobs, which land behind the ones already queued
+        if (jobs_.front()())
+        {
+            jobs_.pop_front();
+            finished++;
+        }
+    } while (!jobs_.empty() && std::chrono::steady_clock::now() < deadline);
+    return finished;
+}
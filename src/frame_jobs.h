@@ -0,0 +1,27 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+
+// One slice of main-thread work per call; returns true once the job is finished, false to be called again
+using FrameJob = std::function<bool()>;
+
+// Work that has to run on the UI thread (it touches ImGui, SDL or the UI's own state) but is too big for one
+// frame. Jobs run in the order they were posted, a slice at a time, until the frame's budget is spent; whatever is
+// left carries over to the next frame. Main thread only.
+class FrameJobQueue
+{
+public:
+    void post(FrameJob job);
+
+    // Run slices until every job is finished or budget has passed. At least one slice runs per call, so a job
+    // whose slices overrun the budget still makes progress. Returns the number of jobs finished.
+    size_t run(std::chrono::microseconds budget);
+
+    bool empty() const { return jobs_.empty(); }
+    size_t size() const { return jobs_.size(); }
+
+private:
+    std::deque<FrameJob> jobs_;
+};
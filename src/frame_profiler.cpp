@@ -0,0 +1,166 @@
+#include "frame_profiler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const size_t STAGE_COUNT = static_cast<size_t>(FrameStage::Count);
+
+    bool profiler_enabled = false;
+    std::chrono::steady_clock::time_point frame_start;
+    bool frame_open = false;
+
+    // Times accumulated for the frame in progress
+    double current_frame[STAGE_COUNT] = {};
+
+    // Ring buffer of completed frames, one row per stage
+    float history[STAGE_COUNT][PROFILER_HISTORY_SIZE] = {};
+    size_t history_next = 0;
+    size_t history_count = 0;
+}
+
+const char *frame_stage_name(FrameStage stage)
+{
+    switch (stage)
+    {
+    case FrameStage::Frame:
+        return "Frame";
+    case FrameStage::Fire:
+        return "Fire";
+    case FrameStage::PwadList:
+        return "PWAD list";
+    case FrameStage::LaunchCommand:
+        return "Launch command";
+    case FrameStage::ImGuiRender:
+        return "ImGui render";
+    case FrameStage::Present:
+        return "Present";
+    default:
+        return "";
+    }
+}
+
+void set_frame_profiler_enabled(bool enabled)
+{
+    if (enabled != profiler_enabled)
+    {
+        reset_frame_profiler();
+    }
+    profiler_enabled = enabled;
+}
+
+bool is_frame_profiler_enabled()
+{
+    return profiler_enabled;
+}
+
+void begin_profiler_frame()
+{
+    if (!profiler_enabled)
+    {
+        return;
+    }
+    std::fill(std::begin(current_frame), std::end(current_frame), 0.0);
+    frame_start = std::chrono::steady_clock::now();
+    frame_open = true;
+}
+
+void end_profiler_frame()
+{
+    if (!profiler_enabled || !frame_open)
+    {
+        return;
+    }
+    current_frame[static_cast<size_t>(FrameStage::Frame)] =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frame_start).count();
+
+    for (size_t stage = 0; stage < STAGE_COUNT; stage++)
+    {
+        history[stage][history_next] = static_cast<float>(current_frame[stage]);
+    }
+    history_next = (history_next + 1) % PROFILER_HISTORY_SIZE;
+    history_count = std::min(history_count + 1, PROFILER_HISTORY_SIZE);
+    frame_open = false;
+}
+
+void add_stage_time(FrameStage stage, double ms)
+{
+    if (!profiler_enabled || stage >= FrameStage::Count)
+    {
+        return;
+    }
+    current_frame[static_cast<size_t>(stage)] += ms;
+}
+
+double percentile(std::vector<double> samples, double p)
+{
+    if (samples.empty())
+    {
+        return 0.0;
+    }
+    p = std::min(std::max(p, 0.0), 100.0);
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * samples.size()));
+    size_t index = rank == 0 ? 0 : rank - 1;
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+StageStats get_stage_stats(FrameStage stage)
+{
+    StageStats stats;
+    if (stage >= FrameStage::Count || history_count == 0)
+    {
+        return stats;
+    }
+
+    const float *row = history[static_cast<size_t>(stage)];
+    std::vector<double> samples(row, row + history_count);
+    stats.samples = history_count;
+    stats.last_ms = row[(history_next + PROFILER_HISTORY_SIZE - 1) % PROFILER_HISTORY_SIZE];
+    stats.max_ms = *std::max_element(samples.begin(), samples.end());
+    stats.p50_ms = percentile(samples, 50.0);
+    stats.p95_ms = percentile(samples, 95.0);
+    stats.p99_ms = percentile(samples, 99.0);
+    return stats;
+}
+
+std::vector<float> get_stage_history(FrameStage stage)
+{
+    std::vector<float> values;
+    if (stage >= FrameStage::Count)
+    {
+        return values;
+    }
+
+    const float *row = history[static_cast<size_t>(stage)];
+    size_t first = history_count < PROFILER_HISTORY_SIZE ? 0 : history_next;
+    values.reserve(history_count);
+    for (size_t i = 0; i < history_count; i++)
+    {
+        values.push_back(row[(first + i) % PROFILER_HISTORY_SIZE]);
+    }
+    return values;
+}
+
+void reset_frame_profiler()
+{
+    history_next = 0;
+    history_count = 0;
+    frame_open = false;
+}
+
+ScopedStageTimer::ScopedStageTimer(FrameStage stage) : stage(stage), active(profiler_enabled)
+{
+    if (active)
+    {
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+ScopedStageTimer::~ScopedStageTimer()
+{
+    if (active)
+    {
+        add_stage_time(stage, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+// Stages timed every frame. Frame covers the whole loop iteration and is recorded by end_profiler_frame().
+enum class FrameStage
+{
+    Frame,
+    Fire,
+    PwadList,
+    LaunchCommand,
+    ImGuiRender,
+    Present,
+    Count
+};
+
+// Number of frames kept for the rolling history and percentiles
+const size_t PROFILER_HISTORY_SIZE = 240;
+
+struct StageStats
+{
+    double last_ms = 0.0;
+    double p50_ms = 0.0;
+    double p95_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+    size_t samples = 0;
+};
+
+const char *frame_stage_name(FrameStage stage);
+
+// Timers are no-ops while disabled, so the hooks can stay in the frame loop
+void set_frame_profiler_enabled(bool enabled);
+bool is_frame_profiler_enabled();
+
+// Stage times are summed over a frame, so a stage that runs twice counts once with the combined time
+void begin_profiler_frame();
+void end_profiler_frame();
+void add_stage_time(FrameStage stage, double ms);
+
+// Nearest-rank percentile (0-100) of the samples; 0 for an empty list
+double percentile(std::vector<double> samples, double p);
+
+StageStats get_stage_stats(FrameStage stage);
+
+// Oldest-first copy of the recorded times for a stage, for plotting
+std::vector<float> get_stage_history(FrameStage stage);
+
+void reset_frame_profiler();
+
+class ScopedStageTimer
+{
+public:
+    explicit ScopedStageTimer(FrameStage stage);
+    ~ScopedStageTimer();
+
+    ScopedStageTimer(const ScopedStageTimer &) = delete;
+    ScopedStageTimer &operator=(const ScopedStageTimer &) = delete;
+
+private:
+    FrameStage stage;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,102 @@
+#include "game_process.h"
+#include <cstdio>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <spawn.h>
+#include <sys/wait.h>
+
+extern char **environ;
+#endif
+
+GameProcess::~GameProcess()
+{
+#ifdef _WIN32
+    if (process_)
+    {
+        CloseHandle(process_);
+    }
+#endif
+    // On POSIX a game still running at exit is left alone; it is reparented once the launcher quits
+}
+
+bool GameProcess::start(const std::string &command)
+{
+    if (running())
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    STARTUPINFOA si;
+    PROCESS_INFORMATION pi;
+    ZeroMemory(&si, sizeof(si));
+    si.cb = sizeof(si);
+    ZeroMemory(&pi, sizeof(pi));
+
+    std::string command_line = command; // CreateProcess may write to the buffer
+    if (!CreateProcessA(NULL, command_line.data(), NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi))
+    {
+        printf("CreateProcess failed (%lu).\n", GetLastError());
+        return false;
+    }
+    CloseHandle(pi.hThread);
+    if (process_)
+    {
+        CloseHandle(process_);
+    }
+    process_ = pi.hProcess;
+#else
+    // The same /bin/sh -c that system() uses, so quoting in custom parameters behaves as before
+    const char *argv[] = {"sh", "-c", command.c_str(), nullptr};
+    pid_t pid = -1;
+    if (posix_spawn(&pid, "/bin/sh", nullptr, nullptr, const_cast<char **>(argv), environ) != 0)
+    {
+        return false;
+    }
+    pid_ = pid;
+#endif
+
+    running_ = true;
+    exit_code_ = -1;
+    started_ = std::chrono::steady_clock::now();
+    return true;
+}
+
+bool GameProcess::running()
+{
+    if (!running_)
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    if (WaitForSingleObject(process_, 0) != WAIT_OBJECT_0)
+    {
+        return true;
+    }
+    DWORD code = 0;
+    exit_code_ = GetExitCodeProcess(process_, &code) ? static_cast<int>(code) : -1;
+    CloseHandle(process_);
+    process_ = nullptr;
+#else
+    int status = 0;
+    pid_t result = waitpid(pid_, &status, WNOHANG);
+    if (result == 0 || (result < 0 && errno == EINTR))
+    {
+        return true;
+    }
+    exit_code_ = result == pid_ && WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    pid_ = -1;
+#endif
+
+    running_ = false;
+    finished_ = std::chrono::steady_clock::now();
+    return false;
+}
+
+double GameProcess::seconds() const
+{
+    auto end = running_ ? std::chrono::steady_clock::now() : finished_;
+    return std::chrono::duration<double>(end - started_).count();
+}
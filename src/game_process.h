@@ -0,0 +1,39 @@
+#pragma once
+#include <chrono>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#endif
+
+// A launched source port, watched without blocking so the launcher keeps drawing while the game runs
+class GameProcess
+{
+public:
+    GameProcess() = default;
+    ~GameProcess();
+    GameProcess(const GameProcess &) = delete;
+    GameProcess &operator=(const GameProcess &) = delete;
+
+    // Run command through the shell (CreateProcess on Windows). Fails if a game is already running.
+    bool start(const std::string &command);
+    // Checks for exit without waiting; cheap enough to call every frame
+    bool running();
+    // Exit code of the last game, or -1 if it did not exit normally
+    int exit_code() const { return exit_code_; }
+    // Seconds the last or current game has been running
+    double seconds() const;
+
+private:
+#ifdef _WIN32
+    HANDLE process_ = nullptr;
+#else
+    pid_t pid_ = -1;
+#endif
+    bool running_ = false;
+    int exit_code_ = -1;
+    std::chrono::steady_clock::time_point started_;
+    std::chrono::steady_clock::time_point finished_;
+};
@@ -2,12 +2,18 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cctype>
 #include <cstring>
 #include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 #ifndef IMGUI_VERSION
@@ -46,6 +52,8 @@ namespace ImGui
 
         FileBrowser &operator=(const FileBrowser &copyFrom);
 
+        ~FileBrowser();
+
         // set the window position (in pixels)
         // default is centered
         void SetWindowPos(int posX, int posY) noexcept;
@@ -103,6 +111,24 @@ namespace ImGui
         // set selected filename to empty
         void ClearSelected();
 
+        // true while the current directory is still being listed in the background
+        bool IsListing() const noexcept;
+
+        // called on the listing thread whenever a directory listing finishes, e.g. to record timings
+        using ListingTimingHook = void (*)(std::chrono::steady_clock::time_point begin,
+                                           std::chrono::steady_clock::time_point end);
+        static void SetListingTimingHook(ListingTimingHook hook) noexcept;
+
+        // runs a directory listing somewhere off the UI thread, e.g. on the application's worker pool.
+        // the listing owns its share of the state, so it stays safe to run after the browser is gone.
+        // without a runner, each browser lists on a thread of its own and joins it before moving on
+        using ListingRunner = void (*)(std::function<void()> listing);
+        static void SetListingRunner(ListingRunner runner) noexcept;
+
+        // called on the listing thread before each batch of entries, e.g. to throttle or pause background I/O
+        using ListingCheckpoint = void (*)();
+        static void SetListingCheckpoint(ListingCheckpoint checkpoint) noexcept;
+
         // (optional) set file type filters. eg. { ".h", ".cpp", ".hpp" }
         // ".*" matches any file types
         void SetTypeFilters(const std::vector<std::string> &typeFilters);
@@ -135,11 +161,46 @@ namespace ImGui
             std::filesystem::path extension;
         };
 
+        // filled by a worker thread and handed over to the UI thread in batches
+        struct PendingListing
+        {
+            std::mutex mutex;
+            std::vector<FileRecord> incoming; // records not yet shown, in directory order
+            std::vector<FileRecord> sorted;   // the complete, sorted listing once done
+            std::string error;
+            bool done = false;
+            std::atomic<bool> cancelled{false};
+        };
+
+        // recently visited directories, reused while the directory's mtime is unchanged
+        struct CachedListing
+        {
+            std::filesystem::path directory;
+            std::filesystem::file_time_type lastWriteTime;
+            std::vector<FileRecord> records;
+        };
+
+        static constexpr size_t MaxCachedListings = 16;
+        static constexpr size_t ListingBatchSize = 256;
+
         static std::string ToLower(const std::string &s);
 
         void ToolTip(const std::string_view &s);
 
-        void UpdateFileRecords();
+        void UpdateFileRecords(bool useCache = true);
+
+        void CancelPendingListing();
+
+        void PollPendingListing();
+
+        void StoreCachedListing(const std::filesystem::file_time_type &lastWriteTime);
+
+        static void ListDirectory(
+            std::shared_ptr<PendingListing> pending, std::filesystem::path directory, bool skipItemsCausingError);
+
+        static bool MakeFileRecord(const std::filesystem::directory_entry &entry, FileRecord &record);
+
+        static void SortFileRecords(std::vector<FileRecord> &records);
 
         void SetCurrentDirectoryUncatched(const std::filesystem::path &pwd);
 
@@ -149,6 +210,11 @@ namespace ImGui
 
         bool IsExtensionMatched(const std::filesystem::path &extension) const;
 
+        bool IsRecordVisible(const FileRecord &record) const;
+
+        // append the indices of visible records from firstRecord onwards to visibleRecordIndices_
+        void AppendVisibleRecords(size_t firstRecord);
+
         void ClearRangeSelectionState();
 
         static void AssignToArrayStyleString(std::vector<char> &arr, std::string_view content);
@@ -193,6 +259,19 @@ namespace ImGui
         std::filesystem::path currentDirectory_;
         std::vector<FileRecord> fileRecords_;
 
+        // indices into fileRecords_ that pass the current filters; rebuilt when the listing or filter changes
+        std::vector<unsigned int> visibleRecordIndices_;
+        bool visibleRecordsDirty_ = true;
+
+        inline static std::atomic<ListingTimingHook> listingTimingHook_{nullptr};
+        inline static std::atomic<ListingRunner> listingRunner_{nullptr};
+        inline static std::atomic<ListingCheckpoint> listingCheckpoint_{nullptr};
+
+        std::shared_ptr<PendingListing> pendingListing_;
+        std::thread listingThread_; // only used when no ListingRunner is set
+        std::filesystem::file_time_type pendingLastWriteTime_;
+        std::vector<CachedListing> cachedListings_; // oldest first
+
         unsigned int rangeSelectionStart_; // enable range selection when shift is pressed
         std::set<std::filesystem::path> selectedFilenames_;
 
@@ -239,6 +318,12 @@ inline ImGui::FileBrowser::FileBrowser(const FileBrowser &copyFrom)
     *this = copyFrom;
 }
 
+inline ImGui::FileBrowser::~FileBrowser()
+{
+    // joins our own listing thread; a listing handed to the runner owns its share of the state
+    CancelPendingListing();
+}
+
 inline ImGui::FileBrowser &ImGui::FileBrowser::operator=(
     const FileBrowser &copyFrom)
 {
@@ -266,8 +351,11 @@ inline ImGui::FileBrowser &ImGui::FileBrowser::operator=(
     selectedFilenames_ = copyFrom.selectedFilenames_;
     rangeSelectionStart_ = copyFrom.rangeSelectionStart_;
 
+    CancelPendingListing();
     currentDirectory_ = copyFrom.currentDirectory_;
     fileRecords_ = copyFrom.fileRecords_;
+    cachedListings_ = copyFrom.cachedListings_;
+    visibleRecordsDirty_ = true;
 
     openNewDirLabel_ = copyFrom.openNewDirLabel_;
     newDirNameBuffer_ = copyFrom.newDirNameBuffer_;
@@ -384,6 +472,8 @@ inline void ImGui::FileBrowser::Display()
     ScopeGuard endPopup([]
                         { EndPopup(); });
 
+    PollPendingListing();
+
     std::filesystem::path newDir;
     bool shouldSetNewDir = false;
 
@@ -535,7 +625,7 @@ inline void ImGui::FileBrowser::Display()
     SameLine();
     if (SmallButton("*"))
     {
-        UpdateFileRecords();
+        UpdateFileRecords(false);
 
         std::set<std::filesystem::path> newSelectedFilenames;
         for (auto &name : selectedFilenames_)
@@ -614,127 +704,126 @@ inline void ImGui::FileBrowser::Display()
         ScopeGuard endChild([]
                             { EndChild(); });
 
-        const bool shouldHideRegularFiles =
-            (flags_ & ImGuiFileBrowserFlags_HideRegularFiles) && (flags_ & ImGuiFileBrowserFlags_SelectDirectory);
+        if (visibleRecordsDirty_)
+        {
+            visibleRecordIndices_.clear();
+            AppendVisibleRecords(0);
+            visibleRecordsDirty_ = false;
+        }
 
-        for (unsigned int rscIndex = 0; rscIndex < fileRecords_.size(); ++rscIndex)
+        // only the rows inside the scroll region are submitted, so huge directories stay cheap
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(visibleRecordIndices_.size()));
+        while (clipper.Step())
         {
-            const auto &rsc = fileRecords_[rscIndex];
-            if (!rsc.isDir && shouldHideRegularFiles)
-            {
-                continue;
-            }
-            if (!rsc.isDir && !IsExtensionMatched(rsc.extension))
-            {
-                continue;
-            }
-            if (!rsc.name.empty() && rsc.name.c_str()[0] == '$')
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
             {
-                continue;
-            }
+                const unsigned int rscIndex = visibleRecordIndices_[row];
+                const auto &rsc = fileRecords_[rscIndex];
 
-            const bool selected = selectedFilenames_.find(rsc.name) != selectedFilenames_.end();
+                const bool selected = selectedFilenames_.find(rsc.name) != selectedFilenames_.end();
 
 #if IMGUI_VERSION_NUM >= 19100
-            const ImGuiSelectableFlags selectableFlag = ImGuiSelectableFlags_NoAutoClosePopups;
+                const ImGuiSelectableFlags selectableFlag = ImGuiSelectableFlags_NoAutoClosePopups;
 #else
-            const ImGuiSelectableFlags selectableFlag = ImGuiSelectableFlags_DontClosePopups;
+                const ImGuiSelectableFlags selectableFlag = ImGuiSelectableFlags_DontClosePopups;
 #endif
 
-            if (Selectable(rsc.showName.c_str(), selected, selectableFlag))
-            {
-                const bool wantDir = flags_ & ImGuiFileBrowserFlags_SelectDirectory;
-                const bool canSelect = rsc.name != ".." && rsc.isDir == wantDir;
-                const bool rangeSelect =
-                    canSelect && GetIO().KeyShift &&
-                    rangeSelectionStart_ < fileRecords_.size() &&
-                    (flags_ & ImGuiFileBrowserFlags_MultipleSelection) &&
-                    IsWindowFocused(ImGuiFocusedFlags_RootAndChildWindows);
-                const bool multiSelect =
-                    !rangeSelect && GetIO().KeyCtrl &&
-                    (flags_ & ImGuiFileBrowserFlags_MultipleSelection) &&
-                    IsWindowFocused(ImGuiFocusedFlags_RootAndChildWindows);
-
-                if (rangeSelect)
+                if (Selectable(rsc.showName.c_str(), selected, selectableFlag))
                 {
-                    const unsigned int first = (std::min)(rangeSelectionStart_, rscIndex);
-                    const unsigned int last = (std::max)(rangeSelectionStart_, rscIndex);
-                    selectedFilenames_.clear();
-                    for (unsigned int i = first; i <= last; ++i)
+                    const bool wantDir = flags_ & ImGuiFileBrowserFlags_SelectDirectory;
+                    const bool canSelect = rsc.name != ".." && rsc.isDir == wantDir;
+                    const bool rangeSelect =
+                        canSelect && GetIO().KeyShift &&
+                        rangeSelectionStart_ < fileRecords_.size() &&
+                        (flags_ & ImGuiFileBrowserFlags_MultipleSelection) &&
+                        IsWindowFocused(ImGuiFocusedFlags_RootAndChildWindows);
+                    const bool multiSelect =
+                        !rangeSelect && GetIO().KeyCtrl &&
+                        (flags_ & ImGuiFileBrowserFlags_MultipleSelection) &&
+                        IsWindowFocused(ImGuiFocusedFlags_RootAndChildWindows);
+
+                    if (rangeSelect)
+                    {
+                        const unsigned int first = (std::min)(rangeSelectionStart_, rscIndex);
+                        const unsigned int last = (std::max)(rangeSelectionStart_, rscIndex);
+                        selectedFilenames_.clear();
+                        for (unsigned int i = first; i <= last; ++i)
+                        {
+                            if (fileRecords_[i].isDir != wantDir)
+                            {
+                                continue;
+                            }
+                            if (!wantDir && !IsExtensionMatched(fileRecords_[i].extension))
+                            {
+                                continue;
+                            }
+                            selectedFilenames_.insert(fileRecords_[i].name);
+                        }
+                    }
+                    else if (selected)
                     {
-                        if (fileRecords_[i].isDir != wantDir)
+                        if (!multiSelect)
                         {
-                            continue;
+                            selectedFilenames_ = {rsc.name};
+                            rangeSelectionStart_ = rscIndex;
                         }
-                        if (!wantDir && !IsExtensionMatched(fileRecords_[i].extension))
+                        else
                         {
-                            continue;
+                            selectedFilenames_.erase(rsc.name);
+                        }
+                        if (flags_ & ImGuiFileBrowserFlags_EnterNewFilename)
+                        {
+                            AssignToArrayStyleString(inputNameBuffer_, "");
                         }
-                        selectedFilenames_.insert(fileRecords_[i].name);
                     }
-                }
-                else if (selected)
-                {
-                    if (!multiSelect)
+                    else if (canSelect)
                     {
-                        selectedFilenames_ = {rsc.name};
+                        if (multiSelect)
+                        {
+                            selectedFilenames_.insert(rsc.name);
+                        }
+                        else
+                        {
+                            selectedFilenames_ = {rsc.name};
+                        }
+                        if (flags_ & ImGuiFileBrowserFlags_EnterNewFilename)
+                        {
+                            const auto rscName = u8StrToStr(rsc.name.u8string());
+                            AssignToArrayStyleString(inputNameBuffer_, rscName);
+                        }
                         rangeSelectionStart_ = rscIndex;
                     }
-                    else
+                }
+
+                if (IsItemClicked(0) && IsMouseDoubleClicked(0))
+                {
+                    if (rsc.isDir)
                     {
-                        selectedFilenames_.erase(rsc.name);
+                        shouldSetNewDir = true;
+                        newDir = (rsc.name != "..") ? (currentDirectory_ / rsc.name) : currentDirectory_.parent_path();
                     }
-                    if (flags_ & ImGuiFileBrowserFlags_EnterNewFilename)
+                    else if (!(flags_ & ImGuiFileBrowserFlags_SelectDirectory))
                     {
-                        AssignToArrayStyleString(inputNameBuffer_, "");
+                        selectedFilenames_ = {rsc.name};
+                        isOk_ = true;
+                        CloseCurrentPopup();
                     }
                 }
-                else if (canSelect)
+                else if (IsKeyPressed(ImGuiKey_GamepadFaceDown) && IsItemHovered())
                 {
-                    if (multiSelect)
+                    if (rsc.isDir)
                     {
-                        selectedFilenames_.insert(rsc.name);
+                        shouldSetNewDir = true;
+                        newDir = (rsc.name != "..") ? (currentDirectory_ / rsc.name) : currentDirectory_.parent_path();
+                        SetKeyboardFocusHere(-1);
                     }
-                    else
+                    else if (!(flags_ & ImGuiFileBrowserFlags_SelectDirectory))
                     {
                         selectedFilenames_ = {rsc.name};
+                        isOk_ = true;
+                        CloseCurrentPopup();
                     }
-                    if (flags_ & ImGuiFileBrowserFlags_EnterNewFilename)
-                    {
-                        const auto rscName = u8StrToStr(rsc.name.u8string());
-                        AssignToArrayStyleString(inputNameBuffer_, rscName);
-                    }
-                    rangeSelectionStart_ = rscIndex;
-                }
-            }
-
-            if (IsItemClicked(0) && IsMouseDoubleClicked(0))
-            {
-                if (rsc.isDir)
-                {
-                    shouldSetNewDir = true;
-                    newDir = (rsc.name != "..") ? (currentDirectory_ / rsc.name) : currentDirectory_.parent_path();
-                }
-                else if (!(flags_ & ImGuiFileBrowserFlags_SelectDirectory))
-                {
-                    selectedFilenames_ = {rsc.name};
-                    isOk_ = true;
-                    CloseCurrentPopup();
-                }
-            }
-            else if (IsKeyPressed(ImGuiKey_GamepadFaceDown) && IsItemHovered())
-            {
-                if (rsc.isDir)
-                {
-                    shouldSetNewDir = true;
-                    newDir = (rsc.name != "..") ? (currentDirectory_ / rsc.name) : currentDirectory_.parent_path();
-                    SetKeyboardFocusHere(-1);
-                }
-                else if (!(flags_ & ImGuiFileBrowserFlags_SelectDirectory))
-                {
-                    selectedFilenames_ = {rsc.name};
-                    isOk_ = true;
-                    CloseCurrentPopup();
                 }
             }
         }
@@ -826,6 +915,11 @@ inline void ImGui::FileBrowser::Display()
         SameLine();
         Text("%s", statusStr_.c_str());
     }
+    else if (pendingListing_ && !(flags_ & ImGuiFileBrowserFlags_NoStatusBar))
+    {
+        SameLine();
+        TextDisabled("listing... (%d)", static_cast<int>(fileRecords_.size() - 1));
+    }
 
     if (!typeFilters_.empty())
     {
@@ -847,6 +941,7 @@ inline void ImGui::FileBrowser::Display()
                     if (Selectable(unique_label.c_str(), selected) && !selected)
                     {
                         typeFilterIndex_ = static_cast<unsigned int>(i);
+                        visibleRecordsDirty_ = true;
                     }
                 }
                 else
@@ -854,6 +949,7 @@ inline void ImGui::FileBrowser::Display()
                     if (Selectable(typeFilters_[i].c_str(), selected) && !selected)
                     {
                         typeFilterIndex_ = static_cast<unsigned int>(i);
+                        visibleRecordsDirty_ = true;
                     }
                 }
             }
@@ -906,6 +1002,26 @@ inline std::vector<std::filesystem::path> ImGui::FileBrowser::GetMultiSelected()
     return ret;
 }
 
+inline bool ImGui::FileBrowser::IsListing() const noexcept
+{
+    return pendingListing_ != nullptr;
+}
+
+inline void ImGui::FileBrowser::SetListingTimingHook(ListingTimingHook hook) noexcept
+{
+    listingTimingHook_ = hook;
+}
+
+inline void ImGui::FileBrowser::SetListingRunner(ListingRunner runner) noexcept
+{
+    listingRunner_ = runner;
+}
+
+inline void ImGui::FileBrowser::SetListingCheckpoint(ListingCheckpoint checkpoint) noexcept
+{
+    listingCheckpoint_ = checkpoint;
+}
+
 inline void ImGui::FileBrowser::ClearSelected()
 {
     selectedFilenames_.clear();
@@ -970,11 +1086,13 @@ inline void ImGui::FileBrowser::SetTypeFilters(const std::vector<std::string> &_
 
     std::copy(typeFilters.begin(), typeFilters.end(), std::back_inserter(typeFilters_));
     typeFilterIndex_ = 0;
+    visibleRecordsDirty_ = true;
 }
 
 inline void ImGui::FileBrowser::SetCurrentTypeFilterIndex(int index)
 {
     typeFilterIndex_ = static_cast<unsigned int>(index);
+    visibleRecordsDirty_ = true;
 }
 
 inline void ImGui::FileBrowser::SetInputName(std::string_view input)
@@ -1003,56 +1121,247 @@ inline void ImGui::FileBrowser::ToolTip(const std::string_view &s)
     ImGui::SetTooltip("%s", s.data());
 }
 
-inline void ImGui::FileBrowser::UpdateFileRecords()
+inline void ImGui::FileBrowser::UpdateFileRecords(bool useCache)
 {
-    fileRecords_ = {FileRecord{true, "..", "[D] ..", ""}};
+    CancelPendingListing();
 
-    for (auto &p : std::filesystem::directory_iterator(currentDirectory_))
+    // opening the directory up front keeps error reporting synchronous, so SetDirectory can still fall back
+    const std::filesystem::directory_iterator probe(currentDirectory_);
+
+    std::error_code ec;
+    const auto lastWriteTime = std::filesystem::last_write_time(currentDirectory_, ec);
+
+    if (useCache && !ec)
     {
-        FileRecord rcd;
-        try
+        for (auto it = cachedListings_.begin(); it != cachedListings_.end(); ++it)
         {
-            if (p.is_regular_file())
+            if (it->directory == currentDirectory_ && it->lastWriteTime == lastWriteTime)
             {
-                rcd.isDir = false;
+                fileRecords_ = it->records;
+                visibleRecordsDirty_ = true;
+
+                // move to the back so it is evicted last
+                CachedListing hit = std::move(*it);
+                cachedListings_.erase(it);
+                cachedListings_.push_back(std::move(hit));
+
+                ClearRangeSelectionState();
+                return;
             }
-            else if (p.is_directory())
+        }
+    }
+
+    // list the directory on a worker thread; Display() shows entries as they arrive
+    fileRecords_ = {FileRecord{true, "..", "[D] ..", ""}};
+    visibleRecordsDirty_ = true;
+    ClearRangeSelectionState();
+
+    pendingListing_ = std::make_shared<PendingListing>();
+    pendingLastWriteTime_ = ec ? std::filesystem::file_time_type::min() : lastWriteTime;
+    auto listing = [pending = pendingListing_, directory = currentDirectory_,
+                    skipItemsCausingError = (flags_ & ImGuiFileBrowserFlags_SkipItemsCausingError) != 0]
+    {
+        ListDirectory(pending, directory, skipItemsCausingError);
+    };
+    if (const ListingRunner runner = listingRunner_)
+    {
+        runner(std::move(listing));
+    }
+    else
+    {
+        listingThread_ = std::thread(std::move(listing));
+    }
+}
+
+inline void ImGui::FileBrowser::CancelPendingListing()
+{
+    if (pendingListing_)
+    {
+        pendingListing_->cancelled = true;
+        pendingListing_.reset();
+    }
+    // the listing stops at its next entry, so this only waits on the entry being read
+    if (listingThread_.joinable())
+    {
+        listingThread_.join();
+    }
+}
+
+inline void ImGui::FileBrowser::PollPendingListing()
+{
+    if (!pendingListing_)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(pendingListing_->mutex);
+    if (pendingListing_->done)
+    {
+        fileRecords_ = std::move(pendingListing_->sorted);
+        visibleRecordsDirty_ = true;
+        if (!pendingListing_->error.empty())
+        {
+            statusStr_ = "error: " + pendingListing_->error;
+        }
+        else if (pendingLastWriteTime_ != std::filesystem::file_time_type::min())
+        {
+            StoreCachedListing(pendingLastWriteTime_);
+        }
+        ClearRangeSelectionState();
+        pendingListing_.reset();
+        return;
+    }
+
+    const size_t firstNewRecord = fileRecords_.size();
+    for (auto &record : pendingListing_->incoming)
+    {
+        fileRecords_.push_back(std::move(record));
+    }
+    pendingListing_->incoming.clear();
+
+    if (!visibleRecordsDirty_)
+    {
+        AppendVisibleRecords(firstNewRecord);
+    }
+}
+
+inline void ImGui::FileBrowser::StoreCachedListing(const std::filesystem::file_time_type &lastWriteTime)
+{
+    cachedListings_.erase(
+        std::remove_if(cachedListings_.begin(), cachedListings_.end(), [&](const CachedListing &cached)
+                       { return cached.directory == currentDirectory_; }),
+        cachedListings_.end());
+
+    if (cachedListings_.size() >= MaxCachedListings)
+    {
+        cachedListings_.erase(cachedListings_.begin());
+    }
+    cachedListings_.push_back({currentDirectory_, lastWriteTime, fileRecords_});
+}
+
+inline bool ImGui::FileBrowser::MakeFileRecord(const std::filesystem::directory_entry &p, FileRecord &rcd)
+{
+    if (p.is_regular_file())
+    {
+        rcd.isDir = false;
+    }
+    else if (p.is_directory())
+    {
+        rcd.isDir = true;
+    }
+    else
+    {
+        return false;
+    }
+
+    rcd.name = p.path().filename();
+    if (rcd.name.empty())
+    {
+        return false;
+    }
+
+    rcd.extension = p.path().filename().extension();
+    rcd.showName = (rcd.isDir ? "[D] " : "[F] ") + u8StrToStr(p.path().filename().u8string());
+    return true;
+}
+
+inline void ImGui::FileBrowser::ListDirectory(
+    std::shared_ptr<PendingListing> pending, std::filesystem::path directory, bool skipItemsCausingError)
+{
+    const auto begin = std::chrono::steady_clock::now();
+    std::vector<FileRecord> all = {FileRecord{true, "..", "[D] ..", ""}};
+    std::vector<FileRecord> batch;
+    std::string error;
+    const ListingCheckpoint checkpoint = listingCheckpoint_;
+
+    // a listing cancelled while it waited for a worker never touches the disk
+    if (pending->cancelled)
+    {
+        return;
+    }
+    if (checkpoint)
+    {
+        checkpoint();
+    }
+
+    try
+    {
+        for (auto &p : std::filesystem::directory_iterator(directory))
+        {
+            if (pending->cancelled)
             {
-                rcd.isDir = true;
+                return;
             }
-            else
+
+            FileRecord rcd;
+            try
             {
-                continue;
+                if (!MakeFileRecord(p, rcd))
+                {
+                    continue;
+                }
             }
-
-            rcd.name = p.path().filename();
-            if (rcd.name.empty())
+            catch (...)
             {
+                if (!skipItemsCausingError)
+                {
+                    throw;
+                }
                 continue;
             }
 
-            rcd.extension = p.path().filename().extension();
-            rcd.showName = (rcd.isDir ? "[D] " : "[F] ") + u8StrToStr(p.path().filename().u8string());
-        }
-        catch (...)
-        {
-            if (!(flags_ & ImGuiFileBrowserFlags_SkipItemsCausingError))
+            all.push_back(rcd);
+            batch.push_back(std::move(rcd));
+            if (batch.size() >= ListingBatchSize)
             {
-                throw;
+                {
+                    std::lock_guard<std::mutex> lock(pending->mutex);
+                    for (auto &record : batch)
+                    {
+                        pending->incoming.push_back(std::move(record));
+                    }
+                }
+                batch.clear();
+                // outside the lock, so a paused listing never stalls the UI thread's poll
+                if (checkpoint)
+                {
+                    checkpoint();
+                }
             }
-            continue;
         }
-        fileRecords_.push_back(rcd);
     }
+    catch (const std::exception &err)
+    {
+        error = err.what();
+    }
+    catch (...)
+    {
+        error = "unknown error";
+    }
+
+    SortFileRecords(all);
 
+    if (const ListingTimingHook hook = listingTimingHook_)
+    {
+        hook(begin, std::chrono::steady_clock::now());
+    }
+
+    std::lock_guard<std::mutex> lock(pending->mutex);
+    pending->sorted = std::move(all);
+    pending->error = std::move(error);
+    pending->done = true;
+}
+
+inline void ImGui::FileBrowser::SortFileRecords(std::vector<FileRecord> &fileRecords)
+{
     // The default lexicographical order does not meet our sorting requirements.
     // We want [b0, a0, A1] to be sorted into something like [a0, A1, b0] instead of [a0, b0, A1].
     // Therefore, here we compute a custom key for each filename for sorting.
-    if (fileRecords_.size() > 2)
+    if (fileRecords.size() > 2)
     {
         std::vector<std::vector<uint32_t>> keys;
-        keys.reserve(fileRecords_.size());
-        for (auto &fileRecord : fileRecords_)
+        keys.reserve(fileRecords.size());
+        for (auto &fileRecord : fileRecords)
         {
             const auto name = u8StrToStr(fileRecord.name.u8string());
             auto &key = keys.emplace_back();
@@ -1072,8 +1381,8 @@ inline void ImGui::FileBrowser::UpdateFileRecords()
         }
 
         std::vector<uint32_t> fileRecordRemapIndices;
-        fileRecordRemapIndices.reserve(fileRecords_.size());
-        for (uint32_t i = 0; i < fileRecords_.size(); ++i)
+        fileRecordRemapIndices.reserve(fileRecords.size());
+        for (uint32_t i = 0; i < fileRecords.size(); ++i)
         {
             fileRecordRemapIndices.push_back(i);
         }
@@ -1083,16 +1392,14 @@ inline void ImGui::FileBrowser::UpdateFileRecords()
             { return keys[li] < keys[ri]; });
 
         std::vector<FileRecord> remappedFileRecords;
-        remappedFileRecords.reserve(fileRecords_.size());
+        remappedFileRecords.reserve(fileRecords.size());
         for (const uint32_t index : fileRecordRemapIndices)
         {
-            remappedFileRecords.emplace_back(std::move(fileRecords_[index]));
+            remappedFileRecords.emplace_back(std::move(fileRecords[index]));
         }
 
-        fileRecords_ = std::move(remappedFileRecords);
+        fileRecords = std::move(remappedFileRecords);
     }
-
-    ClearRangeSelectionState();
 }
 
 inline void ImGui::FileBrowser::SetCurrentDirectoryUncatched(const std::filesystem::path &pwd)
@@ -1199,6 +1506,37 @@ inline bool ImGui::FileBrowser::IsExtensionMatched(const std::filesystem::path &
     return extension == typeFilters_[typeFilterIndex_];
 }
 
+inline bool ImGui::FileBrowser::IsRecordVisible(const FileRecord &record) const
+{
+    const bool shouldHideRegularFiles =
+        (flags_ & ImGuiFileBrowserFlags_HideRegularFiles) && (flags_ & ImGuiFileBrowserFlags_SelectDirectory);
+
+    if (!record.isDir && shouldHideRegularFiles)
+    {
+        return false;
+    }
+    if (!record.isDir && !IsExtensionMatched(record.extension))
+    {
+        return false;
+    }
+    if (!record.name.empty() && record.name.c_str()[0] == '$')
+    {
+        return false;
+    }
+    return true;
+}
+
+inline void ImGui::FileBrowser::AppendVisibleRecords(size_t firstRecord)
+{
+    for (size_t i = firstRecord; i < fileRecords_.size(); ++i)
+    {
+        if (IsRecordVisible(fileRecords_[i]))
+        {
+            visibleRecordIndices_.push_back(static_cast<unsigned int>(i));
+        }
+    }
+}
+
 inline void ImGui::FileBrowser::ClearRangeSelectionState()
 {
     rangeSelectionStart_ = 9999999;
@@ -1,22 +1,39 @@
 #include "launch_utils.h"
 #include <algorithm>
+#include <cstdio>
+#include <ctime>
 #include <filesystem>
 
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
 const std::vector<std::string> WAD_EXTENSIONS = {
     ".wad", ".iwad", ".pwad", ".kpf", ".pk3", ".pk4", ".pk7",
     ".pke", ".lmp", ".mus", ".doom"};
 const std::vector<std::string> DEH_EXTENSIONS = {".deh", ".bex", ".hhe"};
 const std::vector<std::string> EDF_EXTENSIONS = {".edf"};
+const std::vector<std::string> TXT_EXTENSIONS = {".txt"};
 
-bool has_extension(const std::string &filepath, const std::vector<std::string> &extensions)
+bool has_extension(std::string_view filepath, const std::vector<std::string> &extensions)
 {
-    std::string lower_filepath = filepath;
-    std::transform(lower_filepath.begin(), lower_filepath.end(), lower_filepath.begin(), ::tolower);
+    // Compare the tail in place; extensions are lowercase, so only the path needs folding
     return std::any_of(extensions.begin(), extensions.end(),
-                       [&lower_filepath](const std::string &ext)
+                       [&filepath](const std::string &ext)
                        {
-                           return lower_filepath.length() >= ext.length() &&
-                                  lower_filepath.substr(lower_filepath.length() - ext.length()) == ext;
+                           if (filepath.length() < ext.length())
+                           {
+                               return false;
+                           }
+                           size_t start = filepath.length() - ext.length();
+                           for (size_t i = 0; i < ext.length(); i++)
+                           {
+                               if (::tolower(static_cast<unsigned char>(filepath[start + i])) != ext[i])
+                               {
+                                   return false;
+                               }
+                           }
+                           return true;
                        });
 }
 
@@ -90,3 +107,212 @@ std::map<std::string, std::string> build_display_names(const std::vector<std::st
 
     return display_names;
 }
+
+bool DisplayNameCache::update(const nlohmann::json &paths)
+{
+    // Anything that is not an array of strings reads as empty entries, so it cannot force a rebuild every call
+    static const std::string empty;
+    size_t count = paths.is_array() ? paths.size() : 0;
+    auto path_at = [&paths](size_t i) -> const std::string &
+    {
+        return paths[i].is_string() ? paths[i].get_ref<const std::string &>() : empty;
+    };
+
+    bool unchanged = tracking_list_ && count == paths_.size();
+    for (size_t i = 0; unchanged && i < count; i++)
+    {
+        unchanged = path_at(i) == paths_[i];
+    }
+    if (unchanged)
+    {
+        return false;
+    }
+
+    paths_.clear();
+    for (size_t i = 0; i < count; i++)
+    {
+        paths_.push_back(path_at(i));
+    }
+    tracking_list_ = true;
+    build(paths_);
+    return true;
+}
+
+void DisplayNameCache::rebuild(const std::vector<std::string> &paths)
+{
+    paths_.clear();
+    tracking_list_ = false;
+    build(paths);
+}
+
+void DisplayNameCache::build(const std::vector<std::string> &paths)
+{
+    names_.clear();
+    for (auto &[path, name] : build_display_names(paths))
+    {
+        if (name != std::filesystem::path(path).filename().string())
+        {
+            names_.emplace(path, std::move(name));
+        }
+    }
+    generation_++;
+}
+
+std::string DisplayNameCache::get(const std::string &path) const
+{
+    auto it = names_.find(path);
+    return it != names_.end() ? it->second : std::filesystem::path(path).filename().string();
+}
+
+std::string format_file_metadata(uint64_t size, int64_t mtime)
+{
+    const char *units[] = {"bytes", "KB", "MB", "GB"};
+    double value = static_cast<double>(size);
+    size_t unit = 0;
+    while (value >= 1024.0 && unit + 1 < sizeof(units) / sizeof(units[0]))
+    {
+        value /= 1024.0;
+        unit++;
+    }
+
+    char text[64];
+    int length = unit == 0 ? snprintf(text, sizeof(text), "%llu bytes", static_cast<unsigned long long>(size))
+                           : snprintf(text, sizeof(text), "%.1f %s", value, units[unit]);
+
+    std::time_t time = static_cast<std::time_t>(mtime);
+    std::tm local = {};
+#ifdef _WIN32
+    bool have_time = localtime_s(&local, &time) == 0;
+#else
+    bool have_time = localtime_r(&time, &local) != nullptr;
+#endif
+    if (have_time && length > 0 && static_cast<size_t>(length) < sizeof(text))
+    {
+        strftime(text + length, sizeof(text) - length, ", modified %Y-%m-%d", &local);
+    }
+    return text;
+}
+
+void normalize_launch_config(nlohmann::json &config)
+{
+    if (!config.is_object())
+    {
+        config = nlohmann::json::object();
+    }
+    for (const char *key : {"selected_executable", "selected_iwad", "selected_config", "custom_params"})
+    {
+        if (!config.contains(key) || !config[key].is_string())
+        {
+            config[key] = "";
+        }
+    }
+    if (!config.contains("selected_pwads") || !config["selected_pwads"].is_array())
+    {
+        config["selected_pwads"] = nlohmann::json::array();
+    }
+    auto &pwads = config["selected_pwads"];
+    pwads.erase(std::remove_if(pwads.begin(), pwads.end(), [](const nlohmann::json &path)
+                               { return !path.is_string(); }),
+                pwads.end());
+    if (!config.contains("sdl_renderer") || !config["sdl_renderer"].is_string())
+    {
+        config["sdl_renderer"] = "auto";
+    }
+    if (!config.contains("sdl_renderer_inherit") || !config["sdl_renderer_inherit"].is_boolean())
+    {
+        config["sdl_renderer_inherit"] = false;
+    }
+}
+
+std::vector<std::string> get_selected_file_paths(const nlohmann::json &config)
+{
+    std::vector<std::string> paths;
+    std::string iwad = config.value("selected_iwad", "");
+    if (!iwad.empty())
+    {
+        paths.push_back(iwad);
+    }
+    if (config.contains("selected_pwads"))
+    {
+        for (const auto &path : config["selected_pwads"])
+        {
+            paths.push_back(path.get<std::string>());
+        }
+    }
+    std::string selected_config = config.value("selected_config", "");
+    if (!selected_config.empty())
+    {
+        paths.push_back(selected_config);
+    }
+    return paths;
+}
+
+std::string build_launch_command(const nlohmann::json &config)
+{
+    std::string command = "\"" + config.value("selected_executable", "") + "\"";
+    std::string iwad = config.value("selected_iwad", "");
+    std::string custom_params = config.value("custom_params", "");
+    std::string selected_config = config.value("selected_config", "");
+
+    std::vector<std::string> selected_paths;
+    if (config.contains("selected_pwads"))
+    {
+        for (const auto &path : config["selected_pwads"])
+        {
+            selected_paths.push_back(path.get<std::string>());
+        }
+    }
+    command += build_launch_file_args(selected_paths);
+
+    if (!iwad.empty())
+    {
+        command += " -iwad \"" + iwad + "\"";
+    }
+
+    if (!custom_params.empty())
+    {
+        command += " " + custom_params;
+    }
+
+    if (!selected_config.empty())
+    {
+        command += " -config \"" + selected_config + "\"";
+    }
+
+    return command;
+}
+
+#ifdef _WIN32
+void launch_process_win(const char *path)
+{
+    STARTUPINFO si;
+    PROCESS_INFORMATION pi;
+
+    ZeroMemory(&si, sizeof(si));
+    si.cb = sizeof(si);
+    ZeroMemory(&pi, sizeof(pi));
+
+    if (!CreateProcess(NULL,        // No module name (use command line)
+                       (LPSTR)path, // Command line
+                       NULL,        // Process handle not inheritable
+                       NULL,        // Thread handle not inheritable
+                       FALSE,       // Set handle inheritance to FALSE
+                       0,           // No creation flags
+                       NULL,        // Use parent's environment block
+                       NULL,        // Use parent's starting directory
+                       &si,         // Pointer to STARTUPINFO structure
+                       &pi)         // Pointer to PROCESS_INFORMATION structure
+    )
+    {
+        printf("CreateProcess failed (%d).\n", GetLastError());
+        return;
+    }
+
+    // Wait until child process exits.
+    WaitForSingleObject(pi.hProcess, INFINITE);
+
+    // Close process and thread handles.
+    CloseHandle(pi.hProcess);
+    CloseHandle(pi.hThread);
+}
+#endif
@@ -1,20 +1,55 @@
 #pragma once
+#include <cstdint>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
-
-struct PwadFileInfo
-{
-    std::string filepath;
-    bool selected;
-    std::string txt_filepath; // Empty if no txt file exists
-    std::string directory;    // Source directory this file came from
-};
+#include "nlohmann/json.hpp"
 
 extern const std::vector<std::string> WAD_EXTENSIONS;
 extern const std::vector<std::string> DEH_EXTENSIONS;
 extern const std::vector<std::string> EDF_EXTENSIONS;
+extern const std::vector<std::string> TXT_EXTENSIONS; // Companion text files
 
-bool has_extension(const std::string &filepath, const std::vector<std::string> &extensions);
+bool has_extension(std::string_view filepath, const std::vector<std::string> &extensions);
 std::string build_launch_file_args(const std::vector<std::string> &selected_paths);
 std::map<std::string, std::string> build_display_names(const std::vector<std::string> &paths);
+
+// build_display_names() for one list of paths, recomputed only when that list changes
+class DisplayNameCache
+{
+public:
+    // Rebuild if paths differ from the list the names were built from. Allocation free when nothing changed.
+    bool update(const nlohmann::json &paths);
+    // Unconditional rebuild, for lists that track their own changes. The list itself is not kept, so this stays
+    // light for the PWAD list.
+    void rebuild(const std::vector<std::string> &paths);
+
+    // Display name for a path in the list, or its filename if the path is not in the list
+    std::string get(const std::string &path) const;
+    // Bumped on every rebuild, so anything derived from the names knows when to refresh
+    uint64_t generation() const { return generation_; }
+
+private:
+    void build(const std::vector<std::string> &paths);
+
+    std::vector<std::string> paths_;           // The list update() compares against
+    bool tracking_list_ = false;               // False after rebuild(), which does not keep the list
+    std::map<std::string, std::string> names_; // Only names that differ from the plain filename
+    uint64_t generation_ = 0;
+};
+
+// "12.3 MB, modified 2024-05-01" for tooltips; mtime is seconds since the epoch, shown in local time
+std::string format_file_metadata(uint64_t size, int64_t mtime);
+
+// Every file the source port will be asked to open (IWAD, PWADs, config file), in load order
+// Give every field the launch reads its default when it is missing, null or of the wrong type, as
+// setup_config_file() does for the window. Headless launches read the file without that setup.
+void normalize_launch_config(nlohmann::json &config);
+
+std::vector<std::string> get_selected_file_paths(const nlohmann::json &config);
+std::string build_launch_command(const nlohmann::json &config);
+
+#ifdef _WIN32
+void launch_process_win(const char *path);
+#endif
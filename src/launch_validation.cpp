@@ -0,0 +1,122 @@
+#include "launch_validation.h"
+#include "launch_utils.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const std::vector<std::string> WAD_HEADER_EXTENSIONS = {".wad", ".iwad", ".pwad"};
+    const std::vector<std::string> ZIP_HEADER_EXTENSIONS = {".pk3", ".pk4", ".pke", ".kpf"};
+    const std::vector<std::string> SEVEN_ZIP_HEADER_EXTENSIONS = {".pk7"};
+    const size_t HEADER_SIZE = 6;
+
+    bool header_matches(const std::string &path, const unsigned char *header, size_t length)
+    {
+        if (has_extension(path, WAD_HEADER_EXTENSIONS))
+        {
+            return length >= 4 && (memcmp(header, "IWAD", 4) == 0 || memcmp(header, "PWAD", 4) == 0);
+        }
+        if (has_extension(path, ZIP_HEADER_EXTENSIONS))
+        {
+            // Local file header, or the end-of-central-directory record of an empty archive
+            return length >= 4 && (memcmp(header, "PK\x03\x04", 4) == 0 || memcmp(header, "PK\x05\x06", 4) == 0);
+        }
+        if (has_extension(path, SEVEN_ZIP_HEADER_EXTENSIONS))
+        {
+            return length >= 6 && memcmp(header, "7z\xBC\xAF\x27\x1C", 6) == 0;
+        }
+        // Lumps, DEH/BEX and EDF files have no magic number to check
+        return true;
+    }
+}
+
+LaunchFileProblem check_launch_file(const std::string &path)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+    {
+        return LaunchFileProblem::Missing;
+    }
+    if ((st.st_mode & S_IFMT) != S_IFREG)
+    {
+        return LaunchFileProblem::WrongType;
+    }
+
+    size_t length = std::min<size_t>(HEADER_SIZE, static_cast<size_t>(st.st_size));
+
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return LaunchFileProblem::Unreadable;
+    }
+
+    bool matches = true;
+    if (length == 0)
+    {
+        matches = header_matches(path, nullptr, 0);
+    }
+    else
+    {
+        // Map only the first page so big PK3s are not read just to check their magic
+        void *mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED)
+        {
+            close(fd);
+            return LaunchFileProblem::Unreadable;
+        }
+        matches = header_matches(path, static_cast<const unsigned char *>(mapped), length);
+        munmap(mapped, length);
+    }
+    close(fd);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return LaunchFileProblem::Unreadable;
+    }
+
+    unsigned char header[HEADER_SIZE] = {};
+    file.read(reinterpret_cast<char *>(header), length);
+    bool matches = header_matches(path, header, static_cast<size_t>(file.gcount()));
+#endif
+
+    return matches ? LaunchFileProblem::None : LaunchFileProblem::WrongType;
+}
+
+std::vector<LaunchFileIssue> validate_launch_files(const std::vector<std::string> &paths)
+{
+    std::vector<LaunchFileIssue> issues;
+    for (const auto &path : paths)
+    {
+        LaunchFileProblem problem = check_launch_file(path);
+        if (problem != LaunchFileProblem::None)
+        {
+            issues.push_back({path, problem});
+        }
+    }
+    return issues;
+}
+
+std::string describe_launch_file_problem(LaunchFileProblem problem)
+{
+    switch (problem)
+    {
+    case LaunchFileProblem::Missing:
+        return "Missing";
+    case LaunchFileProblem::Unreadable:
+        return "Unreadable";
+    case LaunchFileProblem::WrongType:
+        return "Wrong file type";
+    default:
+        return "OK";
+    }
+}
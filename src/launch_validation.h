@@ -0,0 +1,25 @@
+#pragma once
+#include <string>
+#include <vector>
+
+enum class LaunchFileProblem
+{
+    None,
+    Missing,    // Path does not exist
+    Unreadable, // Exists but cannot be opened
+    WrongType   // Not a regular file, or the header does not match the extension
+};
+
+struct LaunchFileIssue
+{
+    std::string path;
+    LaunchFileProblem problem;
+};
+
+// Check a single file that is about to be passed to the source port
+LaunchFileProblem check_launch_file(const std::string &path);
+
+// Check every path in one pass and return only the ones with problems, in input order
+std::vector<LaunchFileIssue> validate_launch_files(const std::vector<std::string> &paths);
+
+std::string describe_launch_file_problem(LaunchFileProblem problem);
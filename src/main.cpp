@@ -2,17 +2,35 @@
 #include <cassert>
 #include <fstream>
 #include <SDL.h>
+#include <chrono>
 #include <filesystem>
 #include <map>
+#include <sstream>
+#include <thread>
 
 #include "nlohmann/json.hpp"
 #include "imgui/imgui.h"
 #include "imgui/imgui_impl_sdl2.h"
 #include "imgui/imgui_impl_sdlrenderer2.h"
 #include "imgui-filebrowser/imfilebrowser.h"
+#include "alloc_tracker.h"
+#include "background_io.h"
+#include "cli.h"
 #include "config_migration.h"
+#include "config_store.h"
 #include "config_utils.h"
+#include "frame_jobs.h"
+#include "frame_profiler.h"
+#include "game_process.h"
 #include "launch_utils.h"
+#include "launch_validation.h"
+#include "prefetch.h"
+#include "profile_utils.h"
+#include "pwad_index.h"
+#include "pwad_scan.h"
+#include "pwad_snapshot.h"
+#include "task_scheduler.h"
+#include "trace.h"
 
 #include "fire.h"
 
@@ -37,11 +55,86 @@ int color_buffer_width, color_buffer_height;
 int launch_button_height = 35;
 char command_buf[1024] = "THIS IS THE COMMAND";
 char custom_params_buf[1024] = "";
-std::vector<PwadFileInfo> pwads;
+char profile_name_buf[128] = "";
+// The PWAD model the UI draws. Scans publish each new snapshot to published_pwad_snapshot, which later scans
+// build on; the UI switches to it once the display state for it is ready.
+PwadSnapshotPtr pwad_snapshot = std::make_shared<const PwadSnapshot>();
+PwadSnapshotSlot published_pwad_snapshot;
+std::vector<uint8_t> pwad_selected; // Per record of pwad_snapshot, see PwadSnapshot::record()
+
+// Where a file sits in a snapshot: which listing, and its index in that listing's files
+struct PwadRecordRef
+{
+    uint32_t listing;
+    uint32_t index;
+};
+
+// One row of the PWAD list in display order, rebuilt by sort_pwad_list()
+struct PwadRowLabel
+{
+    PwadRecordRef ref;
+    uint32_t record; // pwad_snapshot->record() of ref, which keys pwad_selected
+    std::string filename;
+    std::string lower_filename; // For the case-insensitive search
+};
+std::vector<PwadRowLabel> pwad_row_labels;
+uint64_t pwad_sort_count = 0; // Bumped by every sort_pwad_list(), so a staged update can tell it went stale
+std::vector<std::string> pwad_directory_labels; // Header names, one per pwad_snapshot listing
+
+// Disambiguated display names for each path list, see DisplayNameCache
+DisplayNameCache executable_names;
+DisplayNameCache iwad_names;
+DisplayNameCache config_file_names;
+DisplayNameCache pwad_names;           // Rebuilt by refresh_pwad_names() when a scan lands
+DisplayNameCache pwad_directory_names; // Directory header names
+
+// Set when config has unsaved changes; flushed once at the end of the frame
+bool config_dirty = false;
+
+// Committed snapshots of config for background readers and writers; config itself is only touched by the UI
+ConfigStore config_store;
+
+// Runs background work; results come back through its main thread queue, drained once per frame
+std::unique_ptr<TaskScheduler> task_scheduler;
+
+// Main-thread work too big for one frame, run a slice at a time within this much of each frame
+FrameJobQueue frame_jobs;
+const std::chrono::microseconds FRAME_JOB_BUDGET(2000);
+
+// Background PWAD scan state. A result is only applied if no newer scan was started meanwhile.
+int pwad_scan_generation = 0;
+CancellationToken pwad_scan_token; // Cancelled when a newer scan replaces the running one
+bool pwad_scan_pending = false;         // The list waits for the scan and shows a placeholder
+bool pwad_revalidation_pending = false; // Network directories are rescanned behind the list on screen
+
+// How each PWAD directory was last listed, shown in the settings view
+std::vector<PwadRootStatus> pwad_root_status;
+bool pwad_has_network_roots = false;
+std::chrono::steady_clock::time_point last_pwad_revalidation;
+
+// Startup phase timing: the window is shown before the PWAD scan and file dialog setup finish
+std::chrono::steady_clock::time_point startup_begin;
+double time_to_first_frame_ms = -1.0;
+double time_to_interactive_ms = -1.0;
+bool file_dialogs_configured = false;
 
 // Global variables for TXT file error messaging
 std::string txt_file_error_message = "";
 
+// Result of the last timed launch, shown in the settings view
+std::string last_launch_report = "";
+
+// The running source port. Launching no longer blocks, so the launcher keeps drawing (slowly) behind the game.
+GameProcess game_process;
+bool game_running = false;
+std::chrono::steady_clock::time_point launch_start;
+bool awaiting_game_window = false; // Timing a launch until the launcher loses focus, normally to the game's window
+// Focus lost sooner than this after launching is not the game's window; no source port opens one that fast
+const std::chrono::milliseconds GAME_WINDOW_MIN_DELAY(250);
+
+// Problems found with the selected files on the last launch attempt
+std::vector<LaunchFileIssue> launch_issues;
+
 uint32_t *color_buffer = nullptr;
 nlohmann::json config = {
     {"resolution", {800, 600}},
@@ -129,39 +222,6 @@ static int selected_font_scale_index = 1; // Default to 1.0f (100%)
 
 #ifdef _WIN32
 #include <windows.h>
-
-void launch_process_win(const char *path)
-{
-    STARTUPINFO si;
-    PROCESS_INFORMATION pi;
-
-    ZeroMemory(&si, sizeof(si));
-    si.cb = sizeof(si);
-    ZeroMemory(&pi, sizeof(pi));
-
-    if (!CreateProcess(NULL,        // No module name (use command line)
-                       (LPSTR)path, // Command line
-                       NULL,        // Process handle not inheritable
-                       NULL,        // Thread handle not inheritable
-                       FALSE,       // Set handle inheritance to FALSE
-                       0,           // No creation flags
-                       NULL,        // Use parent's environment block
-                       NULL,        // Use parent's starting directory
-                       &si,         // Pointer to STARTUPINFO structure
-                       &pi)         // Pointer to PROCESS_INFORMATION structure
-    )
-    {
-        printf("CreateProcess failed (%d).\n", GetLastError());
-        return;
-    }
-
-    // Wait until child process exits.
-    WaitForSingleObject(pi.hProcess, INFINITE);
-
-    // Close process and thread handles.
-    CloseHandle(pi.hProcess);
-    CloseHandle(pi.hThread);
-}
 #endif
 
 static void help_marker(const char *desc)
@@ -199,6 +259,62 @@ ImGui::FileBrowser iwad_file_dialog(ImGuiFileBrowserFlags_CloseOnEsc);
 ImGui::FileBrowser pwad_file_dialog(ImGuiFileBrowserFlags_SelectDirectory);
 ImGui::FileBrowser config_file_dialog(ImGuiFileBrowserFlags_CloseOnEsc);
 
+// Read-only config access for per-frame code. Non-const operator[] emplaces a map node on every call and
+// comparing against a literal builds a temporary json, so both allocate; these lookups do not.
+const nlohmann::json &config_value(const char *key)
+{
+    static const nlohmann::json missing;
+    auto it = config.find(key);
+    return it != config.end() ? *it : missing;
+}
+
+const std::string &config_string(const char *key)
+{
+    static const std::string empty;
+    const nlohmann::json &value = config_value(key);
+    return value.is_string() ? value.get_ref<const std::string &>() : empty;
+}
+
+// A label derived from a config string, rebuilt only when that string or the display names it uses change
+struct CachedLabel
+{
+    std::string source;
+    std::string text;
+    uint64_t names_generation = 0;
+    bool built = false;
+};
+
+template <typename BuildLabel>
+const char *cached_label(CachedLabel &cache, const std::string &source, uint64_t names_generation, BuildLabel build_label)
+{
+    if (!cache.built || cache.source != source || cache.names_generation != names_generation)
+    {
+        cache.source = source;
+        cache.text = build_label(source);
+        cache.names_generation = names_generation;
+        cache.built = true;
+    }
+    return cache.text.c_str();
+}
+
+// Batch config writes: any number of changes in one frame cost a single write
+void mark_config_dirty()
+{
+    config_dirty = true;
+}
+
+void flush_config_if_dirty()
+{
+    if (config_dirty)
+    {
+        // Serialized and written on a worker from the committed snapshot while the UI goes on editing config
+        ConfigSnapshotPtr snapshot = config_store.commit(config);
+        task_scheduler->submit([snapshot, path = get_config_file_path()]
+                               { config_store.save(path, *snapshot); });
+        config_dirty = false;
+    }
+}
+
 void set_cursor_hand()
 {
     if (ImGui::IsItemHovered())
@@ -289,150 +405,450 @@ void show_txt_file_error()
     }
 }
 
-std::string get_launch_command()
+// The config fields build_launch_command() reads; the command is rebuilt only when one of them changes
+const char *const LAUNCH_COMMAND_INPUTS[] = {"selected_executable", "selected_iwad", "selected_pwads",
+                                             "custom_params", "selected_config"};
+const size_t LAUNCH_COMMAND_INPUT_COUNT = sizeof(LAUNCH_COMMAND_INPUTS) / sizeof(LAUNCH_COMMAND_INPUTS[0]);
+
+const std::string &get_launch_command()
 {
-    std::string command = "\"" + config["selected_executable"].get<std::string>() + "\"";
-    std::string iwad = config["selected_iwad"];
-    std::string custom_params = config["custom_params"];
-    std::string selected_config = config["selected_config"];
+    ScopedStageTimer timer(FrameStage::LaunchCommand);
+    AllocationScope allocation_scope("get_launch_command");
 
-    std::vector<std::string> selected_paths;
-    for (const auto &path : config["selected_pwads"])
+    static nlohmann::json cached_inputs[LAUNCH_COMMAND_INPUT_COUNT];
+    static std::string cached_command;
+    static bool built = false;
+
+    bool changed = !built;
+    for (size_t i = 0; i < LAUNCH_COMMAND_INPUT_COUNT && !changed; i++)
     {
-        selected_paths.push_back(path.get<std::string>());
+        changed = config_value(LAUNCH_COMMAND_INPUTS[i]) != cached_inputs[i];
     }
-    command += build_launch_file_args(selected_paths);
-
-    if (!iwad.empty())
+    if (changed)
     {
-        command += " -iwad \"" + iwad + "\"";
+        for (size_t i = 0; i < LAUNCH_COMMAND_INPUT_COUNT; i++)
+        {
+            cached_inputs[i] = config_value(LAUNCH_COMMAND_INPUTS[i]);
+        }
+        cached_command = build_launch_command(config);
+        built = true;
     }
+    return cached_command;
+}
 
-    if (!custom_params.empty())
+// Warm the page cache for everything the source port is about to read
+void prefetch_selected_files()
+{
+    if (!config["prefetch_selected_files"].get<bool>())
     {
-        command += " " + custom_params;
+        return;
     }
 
-    if (!selected_config.empty())
+    std::vector<std::string> paths = get_selected_file_paths(config);
+    uint64_t budget = config["prefetch_budget_mb"].get<uint64_t>() * 1024 * 1024;
+    prefetch_files(paths, budget);
+}
+
+void sort_pwad_list();
+// What the PWAD display order depends on besides the files; read from config on the UI thread, or from a committed
+// config snapshot on a worker
+struct PwadOrderSettings
+{
+    const nlohmann::json &directories;    // pwad_directories, for the group order
+    const nlohmann::json &selected_pwads; // In selection order
+    bool pin_selected;
+    bool group_by_directory;
+};
+std::vector<PwadRecordRef> pwad_display_order(const PwadSnapshot &snapshot, const PwadOrderSettings &settings,
+                                              std::vector<uint8_t> &selected);
+void append_pwad_row_labels(const PwadSnapshot &snapshot, const DisplayNameCache &names,
+                            const std::vector<PwadRecordRef> &order, size_t first, size_t last,
+                            std::vector<PwadRowLabel> &labels);
+void refresh_pwad_directory_labels();
+
+// Rebuild the PWAD display names after the scanned file set changes; re-sorting alone keeps them
+void refresh_pwad_names()
+{
+    std::vector<std::string> paths;
+    paths.reserve(pwad_snapshot->size());
+    for (const auto &listing : pwad_snapshot->listings())
     {
-        command += " -config \"" + selected_config + "\"";
+        for (size_t i = 0; i < listing->files.size(); i++)
+        {
+            paths.push_back(listing->files.filepath(i));
+        }
     }
+    pwad_names.rebuild(paths);
+}
+
+// Sizes and dates are shown in the PWAD tooltips, so scans collect them too. Local directories stat from a thread
+// pool, which beats io_uring there. Network directories use io_uring to overlap the round trips, with fewer requests
+// in flight, since every one goes to a server that other clients share.
+PwadScanPolicy pwad_scan_policy(bool prefer_index)
+{
+    PwadScanPolicy policy;
+    policy.local.collect_metadata = true;
+    policy.local.checkpoint = []
+    {
+        background_io_checkpoint(); // Throttled or paused while a game runs
+        return true;
+    };
+    policy.network = policy.local;
+    size_t max_requests = static_cast<size_t>(std::max(1, config_value("network_max_requests").get<int>()));
+    policy.network.max_metadata_requests = max_requests;
+    policy.network.max_threads = std::min<size_t>(max_requests, 4);
+    policy.network.metadata_backend = BatchStatBackend::IoUring;
+    policy.prefer_index = prefer_index;
+    policy.index_path = get_application_support_path() + "/pwad_index.json";
+    return policy;
+}
+
+void set_pwad_root_status(const std::vector<PwadRootStatus> &roots)
+{
+    pwad_root_status = roots;
+    pwad_has_network_roots = std::any_of(pwad_root_status.begin(), pwad_root_status.end(), [](const PwadRootStatus &status)
+                                         { return status.filesystem.kind == FilesystemKind::Network; });
+    last_pwad_revalidation = std::chrono::steady_clock::now();
+}
+
+void apply_pwad_scan(PwadIndexedScan result)
+{
+    pwad_snapshot = make_pwad_snapshot(published_pwad_snapshot.load().get(), std::move(result));
+    published_pwad_snapshot.publish(pwad_snapshot);
+    set_pwad_root_status(pwad_snapshot->roots());
+    refresh_pwad_names();
+    sort_pwad_list();
+}
+
+void start_pwad_scan_async(bool revalidate = false);
 
-    return command;
+// True if every root was seen on a local disk by the last scan, so scanning it here cannot stall on the network
+bool pwad_roots_known_local(const std::vector<PwadScanRoot> &roots)
+{
+    return std::all_of(roots.begin(), roots.end(), [](const PwadScanRoot &root)
+                       { return std::any_of(pwad_root_status.begin(), pwad_root_status.end(), [&](const PwadRootStatus &status)
+                                            { return status.directory == root.directory &&
+                                                     status.filesystem.kind == FilesystemKind::Local; }); });
 }
 
 void populate_pwad_list()
 {
-    pwads.clear();
+    TraceScope trace("populate_pwad_list");
+    std::vector<PwadScanRoot> roots = get_pwad_scan_roots(config);
+    if (!pwad_roots_known_local(roots))
+    {
+        start_pwad_scan_async();
+        return;
+    }
+
+    pwad_scan_generation++; // Any scan still running in the background is now stale
+    pwad_scan_token.cancel();
+    pwad_scan_pending = false;
+    pwad_revalidation_pending = false;
+    // A stat per file is too much for the UI thread on a large collection, so the list goes up without sizes and
+    // dates and a background rescan fills them in
+    PwadScanPolicy policy = pwad_scan_policy(true);
+    policy.local.collect_metadata = false;
+    apply_pwad_scan(scan_pwad_roots_indexed(roots, policy));
+    start_pwad_scan_async(true);
+}
+
+// A finished background scan. The worker names and orders the new snapshot; the main thread labels it one slice
+// at a time, so a large list never costs a dropped frame, and switches to it at the end, so the list on screen
+// stays consistent meanwhile.
+struct PwadListUpdate
+{
+    PwadSnapshotPtr snapshot;
+    int generation = 0;
+    int stage = 0;
+    DisplayNameCache names;
+    std::vector<uint8_t> selected;
+    std::vector<PwadRecordRef> order;
+    uint64_t sort_count = 0; // pwad_sort_count when the config that order comes from was committed
+    std::vector<PwadRowLabel> labels;
+};
+
+const size_t PWAD_LABELS_PER_SLICE = 2048;
 
-    // Helper function to check if a file has an allowed extension (WAD, DEH, or EDF)
-    auto has_allowed_extension = [](const std::string &filename)
+// Worker side of a PwadListUpdate: everything that needs only the snapshot and the committed config
+void prepare_pwad_list_update(PwadListUpdate &update, const ConfigSnapshot &settings)
+{
+    const PwadSnapshot &snapshot = *update.snapshot;
+    std::vector<std::string> paths;
+    paths.reserve(snapshot.size());
+    for (const auto &listing : snapshot.listings())
     {
-        std::string lower_filename = filename;
-        std::transform(lower_filename.begin(), lower_filename.end(), lower_filename.begin(), ::tolower);
-        auto matches_ext = [&lower_filename](const std::vector<std::string> &extensions)
+        for (size_t i = 0; i < listing->files.size(); i++)
         {
-            return std::any_of(extensions.begin(), extensions.end(),
-                               [&lower_filename](const std::string &ext)
-                               {
-                                   return lower_filename.length() >= ext.length() &&
-                                          lower_filename.substr(lower_filename.length() - ext.length()) == ext;
-                               });
-        };
-        return matches_ext(WAD_EXTENSIONS) || matches_ext(DEH_EXTENSIONS) || matches_ext(EDF_EXTENSIONS);
-    };
+            paths.push_back(listing->files.filepath(i));
+        }
+    }
+    update.names.rebuild(paths);
+
+    const nlohmann::json &pin = settings.value("pin_selected_pwads_to_top");
+    const nlohmann::json &group = settings.value("group_pwads_by_directory");
+    update.order = pwad_display_order(snapshot,
+                                      {settings.value("pwad_directories"), settings.value("selected_pwads"),
+                                       !pin.is_boolean() || pin.get<bool>(), !group.is_boolean() || group.get<bool>()},
+                                      update.selected);
+    update.labels.reserve(update.order.size());
+}
+
+bool step_pwad_list_update(PwadListUpdate &update)
+{
+    if (update.generation != pwad_scan_generation)
+    {
+        return true; // A newer scan or a reload replaced this one
+    }
 
-    // go through each directory in pwad_directories
-    for (const auto &dir : config["pwad_directories"])
+    if (update.stage == 0 && update.snapshot->same_files_as(*pwad_snapshot))
+    {
+        // Nothing changed on disk (the usual outcome of a revalidation), so the rows on screen stay as they are
+        pwad_snapshot = update.snapshot;
+        update.stage = 1;
+    }
+    if (update.stage == 0)
     {
-        std::filesystem::path directory_path(dir);
-        if (std::filesystem::exists(directory_path) && std::filesystem::is_directory(directory_path))
+        size_t first = update.labels.size();
+        size_t last = std::min(first + PWAD_LABELS_PER_SLICE, update.order.size());
+        append_pwad_row_labels(*update.snapshot, update.names, update.order, first, last, update.labels);
+        if (last == update.order.size())
         {
-            for (const auto &entry : std::filesystem::directory_iterator(directory_path))
+            pwad_snapshot = update.snapshot;
+            pwad_names = std::move(update.names);
+            pwad_selected = std::move(update.selected);
+            pwad_row_labels = std::move(update.labels);
+            refresh_pwad_directory_labels();
+            if (update.sort_count != pwad_sort_count)
             {
-                if (entry.is_regular_file() && has_allowed_extension(entry.path().filename().string()))
-                {
-                    std::string file_path = entry.path().string();
-                    bool is_selected = false;
+                sort_pwad_list(); // The selection or sort options changed while this was staged
+            }
+            update.stage++;
+        }
+        return false;
+    }
 
-                    // Check if this file is in the selected_pwads array
-                    for (const auto &selected_pwad : config["selected_pwads"])
-                    {
-                        if (selected_pwad == file_path)
-                        {
-                            is_selected = true;
-                            break;
-                        }
-                    }
+    set_pwad_root_status(pwad_snapshot->roots());
+    pwad_scan_pending = false;
+    pwad_revalidation_pending = false;
+    if (pwad_snapshot->served_from_index())
+    {
+        start_pwad_scan_async(true); // Now check the network directories for real
+    }
+    return true;
+}
 
-                    // Check for companion .txt file
-                    std::string txt_file_path = "";
-                    std::filesystem::path pwad_path(file_path);
-                    std::string base_name = pwad_path.stem().string(); // Get filename without extension
-                    std::string txt_path = (pwad_path.parent_path() / (base_name + ".txt")).string();
+void finish_pwad_scan(std::shared_ptr<PwadListUpdate> update)
+{
+    if (update->generation != pwad_scan_generation)
+    {
+        return;
+    }
+    frame_jobs.post([update]
+                    { return step_pwad_list_update(*update); });
+}
 
-                    if (std::filesystem::exists(txt_path))
-                    {
-                        txt_file_path = txt_path;
-                    }
+// Scan the PWAD directories on the task scheduler; the result is applied on the main thread, over as many
+// frames as it needs, by finish_pwad_scan(). A revalidation rescans network directories instead of serving them
+// from the index, and leaves the current list on screen meanwhile, so it runs at background priority.
+void start_pwad_scan_async(bool revalidate)
+{
+    pwad_scan_generation++;
+    pwad_scan_pending = !revalidate;
+    pwad_revalidation_pending = revalidate;
+    int generation = pwad_scan_generation;
 
-                    pwads.push_back({file_path, is_selected, txt_file_path, dir.get<std::string>()});
-                }
+    // The scan this one replaces stops at its next directory instead of holding a worker on a slow share
+    pwad_scan_token.cancel();
+    pwad_scan_token = CancellationToken();
+    CancellationToken token = pwad_scan_token;
+
+    PwadScanPolicy policy = pwad_scan_policy(!revalidate);
+    policy.local.checkpoint = [token]
+    {
+        background_io_checkpoint();
+        return !token.cancelled();
+    };
+    policy.network.checkpoint = policy.local.checkpoint;
+
+    // The worker reads the directories and the sort options from a committed snapshot rather than from config,
+    // which the UI may be editing by then
+    task_scheduler->submit(
+        [settings = config_store.commit(config), sort_count = pwad_sort_count, policy, generation, token]
+        {
+            TraceScope trace(policy.prefer_index ? "scan_pwad_directories" : "revalidate_pwad_directories");
+            BackgroundJob job(policy.prefer_index ? "Scan PWAD directories" : "Refresh PWAD directories");
+            std::vector<PwadScanRoot> roots = get_pwad_scan_roots(
+                {{"pwad_directories", settings->value("pwad_directories")},
+                 {"pwad_directory_options", settings->value("pwad_directory_options")}});
+            // Roots whose files did not change keep the published snapshot's listings
+            PwadSnapshotPtr base = published_pwad_snapshot.load();
+            PwadIndexedScan result = scan_pwad_roots_indexed(roots, policy);
+            if (token.cancelled())
+            {
+                return;
+            }
+            auto update = std::make_shared<PwadListUpdate>();
+            update->snapshot = make_pwad_snapshot(base.get(), std::move(result));
+            update->generation = generation;
+            update->sort_count = sort_count;
+            published_pwad_snapshot.publish(update->snapshot);
+            prepare_pwad_list_update(*update, *settings);
+            task_scheduler->post_to_main_thread([update]
+                                                { finish_pwad_scan(update); });
+        },
+        revalidate ? TaskPriority::Background : TaskPriority::Interactive, token);
+}
+
+// Network directories are rescanned in the background every so often
+void poll_pwad_scan()
+{
+    if (pwad_scan_pending || pwad_revalidation_pending)
+    {
+        return;
+    }
+    if (pwad_has_network_roots && !game_running &&
+        std::chrono::steady_clock::now() - last_pwad_revalidation >=
+            std::chrono::minutes(std::max(1, config_value("network_revalidate_minutes").get<int>())))
+    {
+        start_pwad_scan_async(true);
+    }
+}
+
+// Case-insensitive strcmp, matching the order of comparing lowercased copies
+int compare_lowercase(const char *a, const char *b)
+{
+    for (; *a && ::tolower(static_cast<unsigned char>(*a)) == ::tolower(static_cast<unsigned char>(*b)); a++, b++)
+    {
+    }
+    return ::tolower(static_cast<unsigned char>(*a)) - ::tolower(static_cast<unsigned char>(*b));
+}
+
+// Display order for a snapshot: selected PWADs pinned first if enabled, then by directory if grouping, then by
+// filename. Also fills selected, one flag per record, from settings.selected_pwads.
+std::vector<PwadRecordRef> pwad_display_order(const PwadSnapshot &snapshot, const PwadOrderSettings &settings,
+                                              std::vector<uint8_t> &selected)
+{
+    // Rank each listing's directory by its position in config for stable ordering
+    const auto &listings = snapshot.listings();
+    std::vector<int> dir_order(listings.size(), 9999);
+    for (size_t i = 0; i < settings.directories.size(); i++)
+    {
+        const std::string &dir = settings.directories[i].get_ref<const std::string &>();
+        for (size_t l = 0; l < listings.size(); l++)
+        {
+            if (listings[l]->directory == dir && dir_order[l] == 9999)
+            {
+                dir_order[l] = static_cast<int>(i);
             }
         }
     }
 
-    // Build a map from directory path to its index in config for stable ordering
-    std::map<std::string, int> dir_order;
-    for (size_t i = 0; i < config["pwad_directories"].size(); i++)
+    // Build a map from filepath to selection order index, then rank every record once
+    std::map<std::string, int, std::less<>> selection_order;
+    for (size_t i = 0; i < settings.selected_pwads.size(); i++)
     {
-        dir_order[config["pwad_directories"][i].get<std::string>()] = i;
+        selection_order.emplace(settings.selected_pwads[i].get<std::string>(), static_cast<int>(i));
     }
 
-    // Build a map from filepath to selection order index
-    std::map<std::string, int> selection_order;
-    for (size_t i = 0; i < config["selected_pwads"].size(); i++)
+    std::vector<int> selection_rank(snapshot.size(), 9999);
+    std::vector<PwadRecordRef> order;
+    order.reserve(snapshot.size());
+    selected.assign(snapshot.size(), 0);
+    for (size_t l = 0; l < listings.size(); l++)
     {
-        selection_order[config["selected_pwads"][i].get<std::string>()] = i;
+        const PwadList &files = listings[l]->files;
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            size_t record = snapshot.record(l, i);
+            auto it = selection_order.find(std::string_view(files.filepath(i)));
+            selected[record] = it != selection_order.end();
+            if (it != selection_order.end())
+            {
+                selection_rank[record] = it->second;
+            }
+            order.push_back(PwadRecordRef{static_cast<uint32_t>(l), static_cast<uint32_t>(i)});
+        }
     }
 
     // Sort the pwads by selection status first (if pinning), then by directory (if grouping), then by filename
-    std::sort(pwads.begin(), pwads.end(),
-              [&dir_order, &selection_order](const auto &a, const auto &b)
+    std::sort(order.begin(), order.end(),
+              [&snapshot, &settings, &listings, &selected, &dir_order, &selection_rank](PwadRecordRef a, PwadRecordRef b)
               {
+                  size_t record_a = snapshot.record(a.listing, a.index);
+                  size_t record_b = snapshot.record(b.listing, b.index);
+
                   // Pin selected PWADs to top if enabled
-                  if (pin_selected_pwads_to_top && a.selected != b.selected)
+                  if (settings.pin_selected && selected[record_a] != selected[record_b])
                   {
-                      return a.selected > b.selected;
+                      return selected[record_a] > selected[record_b];
                   }
 
                   // When both are selected and pinned, sort by selection order
-                  if (pin_selected_pwads_to_top && a.selected && b.selected)
+                  if (settings.pin_selected && selected[record_a] && selected[record_b])
                   {
-                      int a_sel = selection_order.count(a.filepath) ? selection_order[a.filepath] : 9999;
-                      int b_sel = selection_order.count(b.filepath) ? selection_order[b.filepath] : 9999;
-                      return a_sel < b_sel;
+                      return selection_rank[record_a] < selection_rank[record_b];
                   }
 
                   // Group by directory if enabled
-                  if (group_pwads_by_directory && a.directory != b.directory)
+                  if (settings.group_by_directory && a.listing != b.listing)
                   {
-                      int a_order = dir_order.count(a.directory) ? dir_order[a.directory] : 9999;
-                      int b_order = dir_order.count(b.directory) ? dir_order[b.directory] : 9999;
-                      return a_order < b_order;
+                      return dir_order[a.listing] < dir_order[b.listing];
                   }
 
                   // Sort alphabetically by filename
-                  std::string a_name = std::filesystem::path(a.filepath).filename().string();
-                  std::string b_name = std::filesystem::path(b.filepath).filename().string();
-                  std::transform(a_name.begin(), a_name.end(), a_name.begin(), ::tolower);
-                  std::transform(b_name.begin(), b_name.end(), b_name.begin(), ::tolower);
-                  return a_name < b_name;
+                  return compare_lowercase(listings[a.listing]->files.filename(a.index),
+                                           listings[b.listing]->files.filename(b.index)) < 0;
               });
+    return order;
+}
+
+// Append the row labels for order[first, last) to labels
+void append_pwad_row_labels(const PwadSnapshot &snapshot, const DisplayNameCache &names,
+                            const std::vector<PwadRecordRef> &order, size_t first, size_t last,
+                            std::vector<PwadRowLabel> &labels)
+{
+    for (size_t row = first; row < last; row++)
+    {
+        PwadRowLabel label;
+        label.ref = order[row];
+        label.record = static_cast<uint32_t>(snapshot.record(label.ref.listing, label.ref.index));
+        label.filename = names.get(snapshot.listings()[label.ref.listing]->files.filepath(label.ref.index));
+        label.lower_filename = label.filename;
+        std::transform(label.lower_filename.begin(), label.lower_filename.end(), label.lower_filename.begin(), ::tolower);
+        labels.push_back(std::move(label));
+    }
+}
+
+void refresh_pwad_directory_labels()
+{
+    pwad_directory_names.update(config_value("pwad_directories"));
+    pwad_directory_labels.clear();
+    for (const auto &listing : pwad_snapshot->listings())
+    {
+        pwad_directory_labels.push_back(pwad_directory_names.get(listing->directory));
+    }
+}
+
+// Refresh selection flags from config and re-sort, without rescanning the PWAD directories
+void sort_pwad_list()
+{
+    pwad_sort_count++;
+    std::vector<PwadRecordRef> order =
+        pwad_display_order(*pwad_snapshot,
+                           {config["pwad_directories"], config["selected_pwads"], pin_selected_pwads_to_top,
+                            group_pwads_by_directory},
+                           pwad_selected);
+    refresh_pwad_directory_labels();
+    pwad_row_labels.clear();
+    pwad_row_labels.reserve(order.size());
+    append_pwad_row_labels(*pwad_snapshot, pwad_names, order, 0, order.size(), pwad_row_labels);
 }
 
 void show_pwad_list()
 {
+    ScopedStageTimer timer(FrameStage::PwadList);
+    AllocationScope allocation_scope("show_pwad_list");
     ImGui::SeparatorText("Select PWAD(s)");
 
     // Add a 'Reload' button next to the label with theme colors
@@ -455,11 +871,25 @@ void show_pwad_list()
     ImGui::PushItemWidth(200);
     ImGui::InputTextWithHint("##search_pwad", "Search PWADs...", search_buf, sizeof(search_buf));
     ImGui::PopItemWidth();
+
+    // Lowercase the search text only when it changes
+    static std::string lower_search;
+    static char last_search_buf[sizeof(search_buf)] = "";
+    if (strcmp(search_buf, last_search_buf) != 0)
+    {
+        snprintf(last_search_buf, sizeof(last_search_buf), "%s", search_buf);
+        lower_search = search_buf;
+        std::transform(lower_search.begin(), lower_search.end(), lower_search.begin(), ::tolower);
+    }
     ImGui::PopStyleVar();
     ImGui::PopStyleColor();
 
     ImVec2 avail = ImGui::GetContentRegionAvail();
     float reserved_height = 4 * ImGui::GetFrameHeightWithSpacing() + launch_button_height;
+    if (!launch_issues.empty())
+    {
+        reserved_height += launch_issues.size() * ImGui::GetTextLineHeightWithSpacing() + ImGui::GetFrameHeightWithSpacing();
+    }
     ImVec2 listSize = ImVec2(avail.x, avail.y - reserved_height);
 
     if (ImGui::BeginListBox("##pwad_list_id", listSize))
@@ -470,36 +900,44 @@ void show_pwad_list()
         ImGui::PushStyleColor(ImGuiCol_Border, button_color);
         ImGui::PushStyleVar(ImGuiStyleVar_FrameBorderSize, 1.0f);
 
-        // Track current directory for rendering headers
-        std::string current_directory = "";
-        bool show_directory_headers = group_pwads_by_directory && config["pwad_directories"].size() > 1;
+        if (pwad_scan_pending)
+        {
+            ImGui::TextDisabled("Scanning PWAD directories...");
+        }
+        else if (pwad_revalidation_pending)
+        {
+            ImGui::TextDisabled("Refreshing PWAD directories...");
+        }
+
+        // Only the UI thread replaces pwad_snapshot, so the list cannot change under this frame
+        const auto &listings = pwad_snapshot->listings();
+
+        // Track the directory of the current group for rendering headers
+        uint32_t current_directory = UINT32_MAX;
+        bool show_directory_headers = group_pwads_by_directory && config_value("pwad_directories").size() > 1;
         bool current_directory_collapsed = false;
 
-        for (size_t i = 0; i < pwads.size(); i++)
+        for (size_t row = 0; row < pwad_row_labels.size(); row++)
         {
-            std::string pwad_file_path = pwads[i].filepath;
-            std::string filename = std::filesystem::path(pwad_file_path).filename().string();
+            const PwadRowLabel &label = pwad_row_labels[row];
+            const uint32_t i = label.record;
+            const PwadList &files = listings[label.ref.listing]->files;
+            const uint32_t index = label.ref.index;
 
             // Perform case-insensitive search filtering
-            std::string lower_filename = filename;
-            std::transform(lower_filename.begin(), lower_filename.end(), lower_filename.begin(), ::tolower);
-            std::string lower_search = search_buf;
-            std::transform(lower_search.begin(), lower_search.end(), lower_search.begin(), ::tolower);
-
-            if (!lower_search.empty() && lower_filename.find(lower_search) == std::string::npos)
+            if (!lower_search.empty() && label.lower_filename.find(lower_search) == std::string::npos)
             {
                 continue; // Skip items that don't match the search
             }
 
             // Render collapsible directory header when directory changes (skip for pinned selected items)
-            if (show_directory_headers && !(pin_selected_pwads_to_top && pwads[i].selected))
+            if (show_directory_headers && !(pin_selected_pwads_to_top && pwad_selected[i]))
             {
-                if (pwads[i].directory != current_directory)
+                if (label.ref.listing != current_directory)
                 {
-                    current_directory = pwads[i].directory;
-                    std::string dir_name = std::filesystem::path(current_directory).filename().string();
+                    current_directory = label.ref.listing;
                     ImGui::SetNextItemOpen(true, ImGuiCond_Once);
-                    current_directory_collapsed = !ImGui::CollapsingHeader(dir_name.c_str());
+                    current_directory_collapsed = !ImGui::CollapsingHeader(pwad_directory_labels[current_directory].c_str());
                 }
                 if (current_directory_collapsed)
                 {
@@ -508,12 +946,14 @@ void show_pwad_list()
             }
 
             ImGui::PushID(i);
-            if (ImGui::Checkbox(filename.c_str(), &pwads[i].selected))
+            bool selected = pwad_selected[i] != 0;
+            if (ImGui::Checkbox(label.filename.c_str(), &selected))
             {
-                if (pwads[i].selected)
+                pwad_selected[i] = selected;
+                if (selected)
                 {
                     // Append newly selected file to preserve order
-                    config["selected_pwads"].push_back(pwads[i].filepath);
+                    config["selected_pwads"].push_back(files.filepath(index));
                 }
                 else
                 {
@@ -521,19 +961,20 @@ void show_pwad_list()
                     auto &arr = config["selected_pwads"];
                     for (auto it = arr.begin(); it != arr.end(); ++it)
                     {
-                        if (*it == pwads[i].filepath)
+                        if (*it == files.filepath(index))
                         {
                             arr.erase(it);
                             break;
                         }
                     }
                 }
-                write_config_file(get_config_file_path(), config);
-                populate_pwad_list(); // Re-sort and update the list after selection change
+                mark_config_dirty();
+                sort_pwad_list(); // Re-sort the list after selection change
+                prefetch_selected_files();
             }
 
             // Add TXT button if companion text file exists
-            if (!pwads[i].txt_filepath.empty())
+            if (files.has_txt(index))
             {
                 ImGui::SameLine();
                 ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.4f, 0.4f, 0.4f, 1.0f));
@@ -543,7 +984,7 @@ void show_pwad_list()
 
                 if (ImGui::Button("TXT", ImVec2(35, 0)))
                 {
-                    open_text_file(pwads[i].txt_filepath);
+                    open_text_file(files.txt_filepath(index));
                 }
 
                 set_cursor_hand();
@@ -553,7 +994,7 @@ void show_pwad_list()
                 {
                     ImGui::BeginTooltip();
                     ImGui::Text("Open companion text file:");
-                    ImGui::TextUnformatted(pwads[i].txt_filepath.c_str());
+                    ImGui::TextUnformatted(files.txt_filepath(index));
                     ImGui::EndTooltip();
                 }
             }
@@ -562,7 +1003,11 @@ void show_pwad_list()
             {
                 ImGui::BeginTooltip();
                 ImGui::PushTextWrapPos(ImGui::GetFontSize() * 35.0f);
-                ImGui::TextUnformatted(pwad_file_path.c_str());
+                ImGui::TextUnformatted(files.filepath(index));
+                if (files.has_metadata(index))
+                {
+                    ImGui::TextDisabled("%s", format_file_metadata(files.file_size(index), files.modified_time(index)).c_str());
+                }
                 ImGui::PopTextWrapPos();
                 ImGui::EndTooltip();
             }
@@ -580,6 +1025,35 @@ void show_pwad_list()
     show_txt_file_error();
 }
 
+// Display problems found by the pre-launch check, one line per file
+void show_launch_issues()
+{
+    if (launch_issues.empty())
+    {
+        return;
+    }
+
+    for (const auto &issue : launch_issues)
+    {
+        std::string filename = std::filesystem::path(issue.path).filename().string();
+        ImGui::TextColored(text_color_red, "%s: %s", describe_launch_file_problem(issue.problem).c_str(), filename.c_str());
+        if (ImGui::IsItemHovered())
+        {
+            ImGui::SetTooltip("%s", issue.path.c_str());
+        }
+    }
+
+    ImGui::PushStyleColor(ImGuiCol_Button, button_color);
+    ImGui::PushStyleColor(ImGuiCol_ButtonHovered, button_hover_color);
+    ImGui::PushStyleColor(ImGuiCol_ButtonActive, button_active_color);
+    if (ImGui::Button("OK##launch_issues", ImVec2(40, 0)))
+    {
+        launch_issues.clear();
+    }
+    set_cursor_hand();
+    ImGui::PopStyleColor(3);
+}
+
 void show_launch_button()
 {
     ImGui::SetNextItemWidth(ImGui::GetWindowWidth());
@@ -588,23 +1062,40 @@ void show_launch_button()
     ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(1.0f, 0.0f, 0.0f, .75f)); // Darker
 
     // Disable button if no executable is selected
-    bool has_executable = !config["selected_executable"].empty();
+    bool has_executable = !config_string("selected_executable").empty();
     if (!has_executable)
     {
         ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.3f, 0.3f, 0.3f, .75f));
         ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.5f, 0.5f, 0.5f, 1.0f));
     }
 
-    if (ImGui::Button("Just Launch Doom!", ImVec2(-1, launch_button_height)) && has_executable)
+    bool launch_clicked = ImGui::Button(game_running ? "Doom is running..." : "Just Launch Doom!",
+                                        ImVec2(-1, launch_button_height));
+    if (ImGui::IsItemHovered() && has_executable)
+    {
+        prefetch_selected_files(); // Give the readahead a head start before the click lands
+    }
+
+    if (launch_clicked && has_executable)
+    {
+        // Catch missing or broken files here instead of after a full source port startup
+        launch_issues = validate_launch_files(get_selected_file_paths(config));
+    }
+
+    if (launch_clicked && has_executable && launch_issues.empty() && !game_running)
     {
         std::string cmd = get_launch_command();
         config["cmd"] = cmd;
-
-#ifdef _WIN32
-        launch_process_win(cmd.c_str());
-#else
-        system(cmd.c_str());
-#endif
+        launch_start = std::chrono::steady_clock::now();
+        if (game_process.start(cmd))
+        {
+            game_running = true;
+            awaiting_game_window = config["measure_launch_time"].get<bool>();
+            // Keep background scans and prefetching out of the game's way until it exits
+            set_background_io_mode(config_string("background_io_while_playing") == "suspend"
+                                       ? BackgroundIoMode::Suspended
+                                       : BackgroundIoMode::LowPriority);
+        }
     }
 
     if (!has_executable)
@@ -627,9 +1118,10 @@ void show_executable_selector()
     ImGui::PushStyleColor(ImGuiCol_FrameBgActive, frame_bg_color);
 
     // Executable selection dropdown
-    std::string selected_exec_path = config["selected_executable"];
-    std::string selected_exec_name = selected_exec_path.empty() ? "Executable: None" : "Executable: " + std::filesystem::path(selected_exec_path).filename().string();
-    const char *display_text = selected_exec_name.c_str();
+    static CachedLabel exec_label;
+    executable_names.update(config_value("doom_executables"));
+    const char *display_text = cached_label(exec_label, config_string("selected_executable"), executable_names.generation(), [](const std::string &path)
+                                            { return path.empty() ? std::string("Executable: None") : "Executable: " + executable_names.get(path); });
 
     // Set a maximum width for the combo box
     ImGui::PushItemWidth(300); // Maximum width of 300 pixels
@@ -643,7 +1135,7 @@ void show_executable_selector()
             if (ImGui::Selectable("Executable: None", is_none_selected))
             {
                 config["selected_executable"] = "";
-                write_config_file(get_config_file_path(), config);
+                mark_config_dirty();
             }
             if (is_none_selected)
             {
@@ -654,13 +1146,13 @@ void show_executable_selector()
         for (size_t i = 0; i < config["doom_executables"].size(); i++)
         {
             std::string exec_path = config["doom_executables"][i];
-            std::string filename = std::filesystem::path(exec_path).filename().string();
+            std::string filename = executable_names.get(exec_path);
             bool is_selected = (config["selected_executable"] == exec_path);
 
             if (ImGui::Selectable(("Executable: " + filename).c_str(), is_selected))
             {
                 config["selected_executable"] = exec_path;
-                write_config_file(get_config_file_path(), config);
+                mark_config_dirty();
             }
             if (is_selected)
             {
@@ -714,7 +1206,7 @@ void show_executable_selector()
             config["doom_executables"].push_back(new_exec);
             // Always select the newly added executable
             config["selected_executable"] = new_exec;
-            write_config_file(get_config_file_path(), config);
+            mark_config_dirty();
         }
         gzdoom_file_dialog.ClearSelected();
         // Sort the doom_executables list alphabetically after adding a new executable
@@ -723,7 +1215,7 @@ void show_executable_selector()
     ImGui::PopStyleColor(1);
 
     // Remove button
-    if (!config["selected_executable"].empty())
+    if (!config_string("selected_executable").empty())
     {
         ImGui::SameLine();
         if (ImGui::Button("Remove##exe"))
@@ -744,7 +1236,7 @@ void show_executable_selector()
                     {
                         config["selected_executable"] = config["doom_executables"][0];
                     }
-                    write_config_file(get_config_file_path(), config);
+                    mark_config_dirty();
                     break;
                 }
             }
@@ -766,28 +1258,14 @@ void show_iwad_button()
     ImGui::PushStyleColor(ImGuiCol_FrameBgHovered, frame_bg_color);
     ImGui::PushStyleColor(ImGuiCol_FrameBgActive, frame_bg_color);
 
-    // Build display names, disambiguating duplicate filenames with numbered suffixes
-    std::vector<std::string> iwad_paths;
-    for (size_t i = 0; i < config["iwads"].size(); i++)
-    {
-        iwad_paths.push_back(config["iwads"][i]);
-    }
-    std::map<std::string, std::string> iwad_display_names = build_display_names(iwad_paths);
-
-    std::string filepath_string = config["selected_iwad"];
-    std::string selected_iwad_name;
-    if (filepath_string.empty())
-    {
-        selected_iwad_name = "IWAD: None";
-    }
-    else
-    {
-        auto it = iwad_display_names.find(filepath_string);
-        selected_iwad_name = "IWAD: " + (it != iwad_display_names.end() ? it->second : std::filesystem::path(filepath_string).filename().string());
-    }
+    // Display names disambiguate duplicate filenames with numbered suffixes
+    static CachedLabel iwad_label;
+    iwad_names.update(config_value("iwads"));
+    const char *selected_iwad_name = cached_label(iwad_label, config_string("selected_iwad"), iwad_names.generation(), [](const std::string &path)
+                                                  { return path.empty() ? std::string("IWAD: None") : "IWAD: " + iwad_names.get(path); });
 
     ImGui::PushItemWidth(300);
-    if (ImGui::BeginCombo("##iwad_selector", selected_iwad_name.c_str(), ImGuiComboFlags_WidthFitPreview))
+    if (ImGui::BeginCombo("##iwad_selector", selected_iwad_name, ImGuiComboFlags_WidthFitPreview))
     {
         // Only show "None" option if there are no IWADs
         if (config["iwads"].empty())
@@ -796,7 +1274,7 @@ void show_iwad_button()
             if (ImGui::Selectable("IWAD: None", is_none_selected))
             {
                 config["selected_iwad"] = "";
-                write_config_file(get_config_file_path(), config);
+                mark_config_dirty();
             }
             if (is_none_selected)
             {
@@ -807,12 +1285,13 @@ void show_iwad_button()
         for (size_t i = 0; i < config["iwads"].size(); i++)
         {
             std::string iwad_path = config["iwads"][i];
-            std::string display_name = iwad_display_names[iwad_path];
+            std::string display_name = iwad_names.get(iwad_path);
             bool is_selected = (config["selected_iwad"] == iwad_path);
             if (ImGui::Selectable(("IWAD: " + display_name).c_str(), is_selected))
             {
                 config["selected_iwad"] = iwad_path;
-                write_config_file(get_config_file_path(), config);
+                mark_config_dirty();
+                prefetch_selected_files();
             }
             if (ImGui::IsItemHovered())
             {
@@ -873,13 +1352,13 @@ void show_iwad_button()
         {
             config["iwads"].push_back(new_iwad);
             config["selected_iwad"] = new_iwad;
-            write_config_file(get_config_file_path(), config);
+            mark_config_dirty();
             // Sort the IWAD list alphabetically after adding a new IWAD
             std::sort(config["iwads"].begin(), config["iwads"].end());
         }
         iwad_file_dialog.ClearSelected();
     }
-    if (!config["selected_iwad"].empty())
+    if (!config_string("selected_iwad").empty())
     {
         ImGui::SameLine();
         if (ImGui::Button("Remove##iwad"))
@@ -898,7 +1377,7 @@ void show_iwad_button()
                     {
                         config["selected_iwad"] = config["iwads"][0];
                     }
-                    write_config_file(get_config_file_path(), config);
+                    mark_config_dirty();
                     break;
                 }
             }
@@ -922,10 +1401,11 @@ void show_config_button()
     ImGui::PushStyleColor(ImGuiCol_FrameBgActive, frame_bg_color);
 
     // Config selection dropdown first
-    // Store the strings in stable variables to avoid dangling pointers
-    std::string selected_config_path = config["selected_config"];
-    std::string selected_config_name = selected_config_path.empty() ? "Config file: None" : "Config file: " + std::filesystem::path(selected_config_path).filename().string();
-    const char *display_text = selected_config_name.c_str();
+    // The label lives in a static cache, so the pointer stays valid for the whole frame
+    static CachedLabel config_label;
+    config_file_names.update(config_value("config_files"));
+    const char *display_text = cached_label(config_label, config_string("selected_config"), config_file_names.generation(), [](const std::string &path)
+                                            { return path.empty() ? std::string("Config file: None") : "Config file: " + config_file_names.get(path); });
 
     // Set a maximum width for the combo box
     ImGui::PushItemWidth(300); // Maximum width of 300 pixels
@@ -937,7 +1417,7 @@ void show_config_button()
         if (ImGui::Selectable("Config file: None", is_none_selected))
         {
             config["selected_config"] = "";
-            write_config_file(get_config_file_path(), config);
+            mark_config_dirty();
         }
         if (is_none_selected)
         {
@@ -953,13 +1433,14 @@ void show_config_button()
         for (size_t i = 0; i < config["config_files"].size(); i++)
         {
             std::string config_path = config["config_files"][i];
-            std::string filename = std::filesystem::path(config_path).filename().string();
+            std::string filename = config_file_names.get(config_path);
             bool is_selected = (config["selected_config"] == config_path);
 
             if (ImGui::Selectable(("Config file: " + filename).c_str(), is_selected))
             {
                 config["selected_config"] = config_path;
-                write_config_file(get_config_file_path(), config);
+                mark_config_dirty();
+                prefetch_selected_files();
             }
             if (is_selected)
             {
@@ -1014,14 +1495,14 @@ void show_config_button()
         {
             config["config_files"].push_back(new_config);
             config["selected_config"] = new_config; // Automatically select the new config
-            write_config_file(get_config_file_path(), config);
+            mark_config_dirty();
         }
         config_file_dialog.ClearSelected();
     }
     ImGui::PopStyleColor(1);
 
     // Remove button
-    if (!config["selected_config"].empty())
+    if (!config_string("selected_config").empty())
     {
         ImGui::SameLine();
         if (ImGui::Button("Remove##config"))
@@ -1033,7 +1514,7 @@ void show_config_button()
                 {
                     config["config_files"].erase(config["config_files"].begin() + i);
                     config["selected_config"] = "";
-                    write_config_file(get_config_file_path(), config);
+                    mark_config_dirty();
                     break;
                 }
             }
@@ -1044,38 +1525,225 @@ void show_config_button()
     ImGui::PopStyleColor(8);
 }
 
-void show_pwad_button()
+// Switch the whole selection in one step: one re-sort, one deferred config write
+void apply_selected_profile(const std::string &name)
+{
+    if (!apply_profile(config, name))
+    {
+        return;
+    }
+
+    config["active_profile"] = name;
+    std::string custom_params = config["custom_params"];
+    snprintf(custom_params_buf, sizeof(custom_params_buf), "%s", custom_params.c_str());
+    launch_issues.clear();
+    sort_pwad_list();
+    prefetch_selected_files();
+    mark_config_dirty();
+}
+
+void show_profile_selector()
 {
     ImGui::PushStyleColor(ImGuiCol_Button, button_color);
     ImGui::PushStyleColor(ImGuiCol_ButtonHovered, button_hover_color);
     ImGui::PushStyleColor(ImGuiCol_ButtonActive, button_active_color);
-    ImGui::PushStyleColor(ImGuiCol_HeaderHovered, button_color);
+    ImGui::PushStyleColor(ImGuiCol_Text, text_color);        // Theme text color
+    ImGui::PushStyleColor(ImGuiCol_PopupBg, frame_bg_color); // Theme background for popup
+    ImGui::PushStyleColor(ImGuiCol_FrameBg, frame_bg_color); // Background of the combo box
+    ImGui::PushStyleColor(ImGuiCol_FrameBgHovered, frame_bg_color);
+    ImGui::PushStyleColor(ImGuiCol_FrameBgActive, frame_bg_color);
 
-    if (ImGui::Button("Add PWAD directory"))
-    {
-        pwad_file_dialog.SetTitle("Select PWAD Directory");
+    // The cache keeps its own copy of the active profile name, which stays valid while the combo changes config
+    static CachedLabel profile_label;
+    const char *selected_profile_name = cached_label(profile_label, config_string("active_profile"), 0, [](const std::string &name)
+                                                     { return name.empty() ? std::string("Profile: None") : "Profile: " + name; });
+    const std::string &active_profile = profile_label.source;
 
-        if (config["pwad_directories"].empty())
+    ImGui::PushItemWidth(300);
+    if (ImGui::BeginCombo("##profile_select", selected_profile_name, ImGuiComboFlags_WidthFitPreview))
+    {
+        std::vector<std::string> names = get_profile_names(config);
+        if (names.empty())
         {
-            pwad_file_dialog.SetPwd("~/");
+            ImGui::Selectable("Profile: None", true);
         }
-        else
+
+        for (const auto &name : names)
         {
-            // Use the last added directory as the starting point
-            std::string last_dir = config["pwad_directories"].back();
-            pwad_file_dialog.SetPwd(last_dir);
+            bool is_selected = (active_profile == name);
+            if (ImGui::Selectable(("Profile: " + name).c_str(), is_selected))
+            {
+                apply_selected_profile(name);
+            }
+            if (is_selected)
+            {
+                ImGui::SetItemDefaultFocus();
+            }
         }
+        ImGui::EndCombo();
+    }
+    set_cursor_hand(); // Add hand cursor for dropdown
+    ImGui::PopItemWidth();
 
-        pwad_file_dialog.Open();
+    // Save button opens a small popup asking for the profile name
+    ImGui::SameLine();
+    if (ImGui::Button("Save##profile"))
+    {
+        snprintf(profile_name_buf, sizeof(profile_name_buf), "%s", active_profile.c_str());
+        ImGui::OpenPopup("Save Profile");
     }
-    help_marker("Add a directory containing PWADs");
+    help_marker("Save the selected executable, IWAD, PWADs, config file and custom parameters as a named profile");
     set_cursor_hand();
 
-    ImGui::PushStyleColor(ImGuiCol_TitleBgActive, dialog_title_color);
-    pwad_file_dialog.Display();
-    if (pwad_file_dialog.HasSelected())
+    if (ImGui::BeginPopup("Save Profile"))
     {
-        std::string new_dir = pwad_file_dialog.GetSelected().string();
+        ImGui::Text("Profile name:");
+        ImGui::PushItemWidth(200);
+        bool submitted = ImGui::InputText("##profile_name", profile_name_buf, sizeof(profile_name_buf), ImGuiInputTextFlags_EnterReturnsTrue);
+        ImGui::PopItemWidth();
+        ImGui::SameLine();
+        submitted |= ImGui::Button("Save##profile_popup");
+        set_cursor_hand();
+
+        if (submitted && profile_name_buf[0] != '\0')
+        {
+            save_profile(config, profile_name_buf);
+            config["active_profile"] = std::string(profile_name_buf);
+            mark_config_dirty();
+            ImGui::CloseCurrentPopup();
+        }
+        ImGui::EndPopup();
+    }
+
+    // Remove button
+    if (!active_profile.empty())
+    {
+        ImGui::SameLine();
+        if (ImGui::Button("Remove##profile"))
+        {
+            delete_profile(config, active_profile);
+            config["active_profile"] = "";
+            mark_config_dirty();
+        }
+        set_cursor_hand();
+    }
+
+    ImGui::PopStyleColor(8);
+}
+
+// Popup with the recursive scan settings of one PWAD directory; changes save and rescan right away
+void show_pwad_directory_options(const std::string &dir)
+{
+    static char exclude_buf[512] = "";
+    if (!ImGui::BeginPopup("pwad_directory_options"))
+    {
+        return;
+    }
+
+    nlohmann::json &options = config["pwad_directory_options"][dir];
+    if (!options.is_object())
+    {
+        options = nlohmann::json::object();
+    }
+    if (ImGui::IsWindowAppearing())
+    {
+        // Show the exclude globs as one comma separated line
+        std::string joined;
+        for (const auto &pattern : options.value("exclude", nlohmann::json::array()))
+        {
+            joined += (joined.empty() ? "" : ", ") + pattern.get<std::string>();
+        }
+        snprintf(exclude_buf, sizeof(exclude_buf), "%s", joined.c_str());
+    }
+
+    bool changed = false;
+    ImGui::TextUnformatted(dir.c_str());
+    ImGui::Separator();
+
+    bool recursive = options.value("recursive", false);
+    if (ImGui::Checkbox("Include subdirectories", &recursive))
+    {
+        options["recursive"] = recursive;
+        changed = true;
+    }
+    set_cursor_hand();
+    help_marker("Also list PWADs in folders below this one. They are grouped under this directory.");
+
+    ImGui::BeginDisabled(!recursive);
+    int max_depth = options.value("max_depth", 8);
+    ImGui::PushItemWidth(120);
+    if (ImGui::InputInt("Max depth", &max_depth))
+    {
+        options["max_depth"] = std::clamp(max_depth, 1, 64);
+        changed = true;
+    }
+    ImGui::PopItemWidth();
+    help_marker("How many folder levels below this directory to look into");
+
+    ImGui::PushItemWidth(300);
+    ImGui::InputTextWithHint("Exclude", "backup, *.bak, author/old*", exclude_buf, sizeof(exclude_buf));
+    ImGui::PopItemWidth();
+    if (ImGui::IsItemDeactivatedAfterEdit())
+    {
+        nlohmann::json patterns = nlohmann::json::array();
+        std::stringstream stream(exclude_buf);
+        std::string pattern;
+        while (std::getline(stream, pattern, ','))
+        {
+            pattern.erase(0, pattern.find_first_not_of(" \t"));
+            pattern.erase(pattern.find_last_not_of(" \t") + 1);
+            if (!pattern.empty())
+            {
+                patterns.push_back(pattern);
+            }
+        }
+        options["exclude"] = patterns;
+        changed = true;
+    }
+    help_marker("Comma separated patterns for folders or files to skip. * matches anything, ? one character.\n"
+                "Patterns are matched against the path below this directory and against the bare name.");
+    ImGui::EndDisabled();
+
+    if (changed)
+    {
+        mark_config_dirty();
+        start_pwad_scan_async();
+    }
+    ImGui::EndPopup();
+}
+
+void show_pwad_button()
+{
+    ImGui::PushStyleColor(ImGuiCol_Button, button_color);
+    ImGui::PushStyleColor(ImGuiCol_ButtonHovered, button_hover_color);
+    ImGui::PushStyleColor(ImGuiCol_ButtonActive, button_active_color);
+    ImGui::PushStyleColor(ImGuiCol_HeaderHovered, button_color);
+
+    if (ImGui::Button("Add PWAD directory"))
+    {
+        pwad_file_dialog.SetTitle("Select PWAD Directory");
+
+        if (config["pwad_directories"].empty())
+        {
+            pwad_file_dialog.SetPwd("~/");
+        }
+        else
+        {
+            // Use the last added directory as the starting point
+            std::string last_dir = config["pwad_directories"].back();
+            pwad_file_dialog.SetPwd(last_dir);
+        }
+
+        pwad_file_dialog.Open();
+    }
+    help_marker("Add a directory containing PWADs");
+    set_cursor_hand();
+
+    ImGui::PushStyleColor(ImGuiCol_TitleBgActive, dialog_title_color);
+    pwad_file_dialog.Display();
+    if (pwad_file_dialog.HasSelected())
+    {
+        std::string new_dir = pwad_file_dialog.GetSelected().string();
         // Check if directory is already in the list
         bool exists = false;
         for (const auto &dir : config["pwad_directories"])
@@ -1096,17 +1764,25 @@ void show_pwad_button()
     ImGui::PopStyleColor(1);
 
     // Display list of PWAD directories
-    if (!config["pwad_directories"].empty())
+    if (!config_value("pwad_directories").empty())
     {
         ImGui::SeparatorText("PWAD Directories");
-        for (size_t i = 0; i < config["pwad_directories"].size(); i++)
+        for (size_t i = 0; i < config_value("pwad_directories").size(); i++)
         {
             ImGui::PushID(i);
-            std::string dir = config["pwad_directories"][i];
+            const std::string &dir = config_value("pwad_directories")[i].get_ref<const std::string &>();
             ImGui::TextColored(text_color_green, "%s", dir.c_str());
             ImGui::SameLine();
+            if (ImGui::Button("Options"))
+            {
+                ImGui::OpenPopup("pwad_directory_options");
+            }
+            set_cursor_hand();
+            show_pwad_directory_options(dir);
+            ImGui::SameLine();
             if (ImGui::Button("Remove"))
             {
+                config["pwad_directory_options"].erase(dir);
                 config["pwad_directories"].erase(config["pwad_directories"].begin() + i);
                 populate_pwad_list();
             }
@@ -1129,10 +1805,11 @@ void show_command()
     ImGui::PushStyleColor(ImGuiCol_FrameBg, frame_bg_color);
     ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
 
-    // Copy current custom params to buffer if it exists
-    if (!config["custom_params"].empty())
+    // Copy current custom params to buffer if it exists and differs, e.g. after a profile switch
+    const std::string &custom_params = config_string("custom_params");
+    if (!custom_params.empty() && strncmp(custom_params_buf, custom_params.c_str(), sizeof(custom_params_buf) - 1) != 0)
     {
-        strncpy(custom_params_buf, config["custom_params"].get<std::string>().c_str(), sizeof(custom_params_buf) - 1);
+        strncpy(custom_params_buf, custom_params.c_str(), sizeof(custom_params_buf) - 1);
         custom_params_buf[sizeof(custom_params_buf) - 1] = '\0';
     }
 
@@ -1184,7 +1861,7 @@ void show_settings_view()
                 {
                     config["theme"] = theme.first;
                     apply_theme(theme.first);
-                    write_config_file(get_config_file_path(), config);
+                    mark_config_dirty();
                 }
                 if (is_selected)
                 {
@@ -1218,7 +1895,7 @@ void show_settings_view()
                     selected_font_scale_index = i;
                     ImGui::GetIO().FontGlobalScale = font_scales[i]; // Apply the font scale
                     config["font_scale"] = font_scales[i];
-                    write_config_file(get_config_file_path(), config);
+                    mark_config_dirty();
                 }
                 if (is_selected)
                 {
@@ -1238,8 +1915,8 @@ void show_settings_view()
         if (ImGui::Checkbox("Pin Selected PWADs to Top", &pin_selected_pwads_to_top))
         {
             config["pin_selected_pwads_to_top"] = pin_selected_pwads_to_top;
-            write_config_file(get_config_file_path(), config);
-            populate_pwad_list(); // Resort the PWAD list based on the new checkbox value
+            mark_config_dirty();
+            sort_pwad_list(); // Resort the PWAD list based on the new checkbox value
         }
         set_cursor_hand(); // Add hand cursor for checkbox
         ImGui::PopStyleVar();
@@ -1253,13 +1930,195 @@ void show_settings_view()
         if (ImGui::Checkbox("Group PWADs by Directory", &group_pwads_by_directory))
         {
             config["group_pwads_by_directory"] = group_pwads_by_directory;
-            write_config_file(get_config_file_path(), config);
-            populate_pwad_list(); // Resort the PWAD list based on the new checkbox value
+            mark_config_dirty();
+            sort_pwad_list(); // Resort the PWAD list based on the new checkbox value
         }
         set_cursor_hand(); // Add hand cursor for checkbox
         ImGui::PopStyleVar();
         ImGui::PopStyleColor();
 
+        ImGui::Spacing();
+
+        // Add a checkbox for warming the page cache before launching
+        bool prefetch_enabled = config["prefetch_selected_files"].get<bool>();
+        ImGui::PushStyleColor(ImGuiCol_Border, button_color);
+        ImGui::PushStyleVar(ImGuiStyleVar_FrameBorderSize, 1.0f);
+        if (ImGui::Checkbox("Prefetch Selected Files", &prefetch_enabled))
+        {
+            config["prefetch_selected_files"] = prefetch_enabled;
+            mark_config_dirty();
+        }
+        set_cursor_hand(); // Add hand cursor for checkbox
+        ImGui::PopStyleVar();
+        ImGui::PopStyleColor();
+        help_marker("Reads the selected IWAD, PWADs and config file into the OS cache in the background "
+                    "when the selection changes or the launch button is hovered, so the game starts faster "
+                    "from slow disks and network shares.");
+
+        ImGui::Spacing();
+
+        // Add a checkbox for timing launches to the game's window, used to compare with and without prefetching
+        bool measure_launch_time = config["measure_launch_time"].get<bool>();
+        ImGui::PushStyleColor(ImGuiCol_Border, button_color);
+        ImGui::PushStyleVar(ImGuiStyleVar_FrameBorderSize, 1.0f);
+        if (ImGui::Checkbox("Measure Time to Game Window", &measure_launch_time))
+        {
+            config["measure_launch_time"] = measure_launch_time;
+            mark_config_dirty();
+        }
+        set_cursor_hand(); // Add hand cursor for checkbox
+        ImGui::PopStyleVar();
+        ImGui::PopStyleColor();
+        help_marker("Reports the time from clicking launch until the launcher loses focus, which is normally the "
+                    "game's window appearing. Switching to another window first ends the timing early, so leave "
+                    "the launcher focused until the game appears. Toggle prefetching to compare.");
+
+        ImGui::Spacing();
+
+        // Add a checkbox for the frame-time overlay
+        bool show_profiler_overlay = is_frame_profiler_enabled();
+        ImGui::PushStyleColor(ImGuiCol_Border, button_color);
+        ImGui::PushStyleVar(ImGuiStyleVar_FrameBorderSize, 1.0f);
+        if (ImGui::Checkbox("Show Frame Profiler", &show_profiler_overlay))
+        {
+            config["show_profiler_overlay"] = show_profiler_overlay;
+            mark_config_dirty();
+            set_frame_profiler_enabled(show_profiler_overlay);
+        }
+        set_cursor_hand(); // Add hand cursor for checkbox
+        ImGui::PopStyleVar();
+        ImGui::PopStyleColor();
+        help_marker("Shows an overlay with per-frame timings for the fire effect, PWAD list, launch command, "
+                    "ImGui rendering and presenting, with p50/p95/p99 over the last few seconds.");
+
+        if (!last_launch_report.empty())
+        {
+            ImGui::TextColored(text_color_green, "%s", last_launch_report.c_str());
+        }
+
+        if (time_to_interactive_ms >= 0.0)
+        {
+            ImGui::Text("Startup: first frame %.0f ms, interactive %.0f ms", time_to_first_frame_ms, time_to_interactive_ms);
+        }
+
+        // How long each PWAD directory took on its last scan, and what it is stored on
+        if (!pwad_root_status.empty())
+        {
+            ImGui::Spacing();
+            ImGui::Text("PWAD directory scans:");
+            int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+                              std::chrono::system_clock::now().time_since_epoch())
+                              .count();
+            for (const auto &status : pwad_root_status)
+            {
+                ImGui::BulletText("%s", status.directory.c_str());
+                ImGui::SameLine();
+                const char *kind = status.filesystem.kind == FilesystemKind::Network ? "network" : "local";
+                const char *type = status.filesystem.type.empty() ? "?" : status.filesystem.type.c_str();
+                if (status.from_index)
+                {
+                    ImGui::TextDisabled("%s (%s), %zu files from index, %.0f ms, indexed %lld min ago", type, kind,
+                                        status.files, status.milliseconds,
+                                        static_cast<long long>(std::max<int64_t>(0, now - status.indexed_at) / 60));
+                }
+                else
+                {
+                    ImGui::TextDisabled("%s (%s), %zu files, %.0f ms", type, kind, status.files, status.milliseconds);
+                }
+            }
+        }
+
+        ImGui::Spacing();
+
+        // Background refresh interval for directories on network shares
+        int revalidate_minutes = config["network_revalidate_minutes"].get<int>();
+        ImGui::PushItemWidth(120);
+        if (ImGui::InputInt("Network Refresh (minutes)", &revalidate_minutes))
+        {
+            config["network_revalidate_minutes"] = std::clamp(revalidate_minutes, 1, 24 * 60);
+            mark_config_dirty();
+        }
+        ImGui::PopItemWidth();
+        help_marker("PWAD directories on network shares (NFS, SMB, sshfs...) are listed from a saved index at "
+                    "startup and rescanned in the background at this interval, so a slow server never holds up "
+                    "the launcher.");
+
+        // Cap on metadata requests in flight against a network share
+        int max_requests = config["network_max_requests"].get<int>();
+        ImGui::PushItemWidth(120);
+        if (ImGui::InputInt("Max Network Requests", &max_requests))
+        {
+            config["network_max_requests"] = std::clamp(max_requests, 1, 256);
+            mark_config_dirty();
+        }
+        ImGui::PopItemWidth();
+        help_marker("How many file lookups a scan keeps in flight against one network share. Lower values "
+                    "are gentler on busy servers.");
+
+        ImGui::Spacing();
+
+        // What background scans and prefetching do while a launched game is running
+        static const std::pair<const char *, const char *> background_io_options[] = {
+            {"low_priority", "Lower priority"}, {"suspend", "Pause"}};
+        const std::string &background_io = config_string("background_io_while_playing");
+        const char *background_io_label = background_io_options[0].second;
+        for (const auto &option : background_io_options)
+        {
+            if (background_io == option.first)
+            {
+                background_io_label = option.second;
+            }
+        }
+        ImGui::Text("Background Work While Playing:");
+        ImGui::PushItemWidth(160);
+        if (ImGui::BeginCombo("##BackgroundIo", background_io_label))
+        {
+            for (const auto &option : background_io_options)
+            {
+                bool is_selected = background_io == option.first;
+                if (ImGui::Selectable(option.second, is_selected))
+                {
+                    config["background_io_while_playing"] = option.first;
+                    mark_config_dirty();
+                    if (game_running)
+                    {
+                        set_background_io_mode(std::string(option.first) == "suspend" ? BackgroundIoMode::Suspended
+                                                                                      : BackgroundIoMode::LowPriority);
+                    }
+                }
+                if (is_selected)
+                {
+                    ImGui::SetItemDefaultFocus();
+                }
+            }
+            ImGui::EndCombo();
+        }
+        set_cursor_hand(); // Add hand cursor for dropdown
+        ImGui::PopItemWidth();
+        help_marker("While a launched game is running, the launcher's scans and prefetching either drop to idle "
+                    "disk and CPU priority, so they only use time the game leaves unused, or pause until the "
+                    "game exits.");
+
+        // Jobs currently running on worker threads and how they are being treated
+        BackgroundIoMode io_mode = get_background_io_mode();
+        ImGui::Text("Background jobs: %s", io_mode == BackgroundIoMode::Suspended     ? "paused while playing"
+                                           : io_mode == BackgroundIoMode::LowPriority ? "low priority while playing"
+                                                                                      : "normal priority");
+        std::vector<BackgroundJobStatus> jobs = get_background_jobs();
+        if (jobs.empty())
+        {
+            ImGui::TextDisabled("  No jobs running");
+        }
+        for (const auto &job : jobs)
+        {
+            ImGui::BulletText("%s", job.name.c_str());
+            ImGui::SameLine();
+            ImGui::TextDisabled("%.1f s, %s", job.seconds,
+                                job.waiting                                    ? "paused"
+                                : job.mode == BackgroundIoMode::LowPriority ? "low priority"
+                                                                              : "normal priority");
+        }
+
         ImGui::Spacing();
         ImGui::Spacing();
 
@@ -1333,7 +2192,7 @@ void show_settings_view()
                 if (ImGui::Selectable(renderer_options[i].second.c_str(), is_selected))
                 {
                     config["sdl_renderer"] = renderer_options[i].first;
-                    write_config_file(get_config_file_path(), config);
+                    mark_config_dirty();
                 }
                 if (is_selected)
                 {
@@ -1360,7 +2219,7 @@ void show_settings_view()
         if (ImGui::Checkbox("Apply renderer to launched games", &inherit_renderer))
         {
             config["sdl_renderer_inherit"] = inherit_renderer;
-            write_config_file(get_config_file_path(), config);
+            mark_config_dirty();
         }
         set_cursor_hand(); // Add hand cursor for checkbox
         ImGui::PopStyleVar();
@@ -1448,7 +2307,7 @@ void show_ui()
                 config["doom_executables"].push_back(new_exec);
                 // Always select the newly added executable
                 config["selected_executable"] = new_exec;
-                write_config_file(get_config_file_path(), config);
+                mark_config_dirty();
             }
             gzdoom_file_dialog.ClearSelected();
         }
@@ -1469,7 +2328,7 @@ void show_ui()
             {
                 config["iwads"].push_back(new_iwad);
                 config["selected_iwad"] = new_iwad;
-                write_config_file(get_config_file_path(), config);
+                mark_config_dirty();
                 // Sort the IWAD list alphabetically after adding a new IWAD
                 std::sort(config["iwads"].begin(), config["iwads"].end());
             }
@@ -1480,6 +2339,10 @@ void show_ui()
         ImGui::SetCursorPos(ImVec2(spacing, ImGui::GetCursorPosY() + spacing));
         show_config_button();
 
+        // Add profile selector with same spacing
+        ImGui::SetCursorPos(ImVec2(spacing, ImGui::GetCursorPosY() + spacing));
+        show_profile_selector();
+
         // Add PWAD button with same spacing
         ImGui::SetCursorPos(ImVec2(spacing, ImGui::GetCursorPosY() + spacing));
         show_pwad_button();
@@ -1487,6 +2350,7 @@ void show_ui()
         // Keep consistent spacing for remaining elements
         show_pwad_list();
         show_command();
+        show_launch_issues();
         show_launch_button();
     }
     ImGui::PopStyleColor(2);
@@ -1498,6 +2362,79 @@ void show_ui()
     }
 }
 
+// Frame-time overlay in the bottom-right corner. Reads last frame's numbers, so it never times itself.
+void show_profiler_overlay()
+{
+    if (!is_frame_profiler_enabled())
+    {
+        return;
+    }
+
+    ImGuiIO &io = ImGui::GetIO();
+    const float padding = 10.0f;
+    ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x - padding, io.DisplaySize.y - padding), ImGuiCond_Always, ImVec2(1.0f, 1.0f));
+    ImGui::SetNextWindowBgAlpha(0.85f);
+
+    ImGuiWindowFlags window_flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+                                    ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing |
+                                    ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoMove;
+
+    ImGui::PushStyleColor(ImGuiCol_Text, text_color);
+    ImGui::PushStyleColor(ImGuiCol_WindowBg, frame_bg_color);
+    if (ImGui::Begin("Frame Profiler", nullptr, window_flags))
+    {
+        std::vector<float> frame_times = get_stage_history(FrameStage::Frame);
+        StageStats frame_stats = get_stage_stats(FrameStage::Frame);
+        char overlay_text[64];
+        snprintf(overlay_text, sizeof(overlay_text), "%.2f ms (%.0f fps)", frame_stats.last_ms,
+                 frame_stats.last_ms > 0.0 ? 1000.0 / frame_stats.last_ms : 0.0);
+        ImGui::PlotHistogram("##frame_times", frame_times.data(), static_cast<int>(frame_times.size()), 0, overlay_text,
+                             0.0f, std::max(33.3f, static_cast<float>(frame_stats.max_ms)), ImVec2(320, 60));
+
+        if (ImGui::BeginTable("##profiler_stages", 5, ImGuiTableFlags_SizingFixedFit))
+        {
+            ImGui::TableSetupColumn("Stage");
+            ImGui::TableSetupColumn("last");
+            ImGui::TableSetupColumn("p50");
+            ImGui::TableSetupColumn("p95");
+            ImGui::TableSetupColumn("p99");
+            ImGui::TableHeadersRow();
+            for (int i = 0; i < static_cast<int>(FrameStage::Count); i++)
+            {
+                FrameStage stage = static_cast<FrameStage>(i);
+                StageStats stats = get_stage_stats(stage);
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(frame_stage_name(stage));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", stats.last_ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", stats.p50_ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", stats.p95_ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", stats.p99_ms);
+            }
+            ImGui::EndTable();
+        }
+
+        // Only meaningful in builds made with TRACK_ALLOCATIONS=1
+        if (allocation_tracking_available())
+        {
+            AllocationCounts frame_allocations = get_last_frame_allocations();
+            ImGui::Text("Allocations: %llu (%.1f KB)", static_cast<unsigned long long>(frame_allocations.allocations),
+                        frame_allocations.bytes / 1024.0);
+            for (const auto &scope : get_last_frame_scope_allocations())
+            {
+                ImGui::Text("  %s: %llu (%.1f KB)", scope.name, static_cast<unsigned long long>(scope.counts.allocations),
+                            scope.counts.bytes / 1024.0);
+            }
+        }
+    }
+    ImGui::End();
+    ImGui::PopStyleColor(2);
+}
+
 void set_color_buffer_size()
 {
     const int MAX_WIDTH = 640;
@@ -1556,7 +2493,7 @@ void process_dropped_item(const char *dropped_path)
             if (!already_exists)
             {
                 config["pwad_directories"].push_back(path.string());
-                write_config_file(get_config_file_path(), config);
+                mark_config_dirty();
                 populate_pwad_list(); // Refresh the PWAD list
             }
         }
@@ -1578,117 +2515,219 @@ void process_dropped_item(const char *dropped_path)
             if (!already_exists)
             {
                 config["pwad_directories"].push_back(parent_dir.string());
-                write_config_file(get_config_file_path(), config);
+                mark_config_dirty();
                 populate_pwad_list(); // Refresh the PWAD list
             }
         }
     }
 }
 
-void update()
+void update_startup_phases();
+
+// The launcher losing focus marks the end of a timed launch. SDL cannot tell which window took the focus, so the
+// report says what was measured: normally that is the game's window appearing, but an alt-tab or a notification
+// ends the timing too.
+void finish_launch_timing()
 {
-    ImGuiIO &io = ImGui::GetIO();
-    bool done = false;
+    awaiting_game_window = false;
+    auto now = std::chrono::steady_clock::now();
+    record_trace_span("time_to_focus_lost", launch_start, now);
+
+    double seconds = std::chrono::duration<double>(now - launch_start).count();
+    char report[256];
+    if (config["prefetch_selected_files"].get<bool>())
+    {
+        PrefetchStats prefetch = get_prefetch_stats();
+        snprintf(report, sizeof(report), "Last launch: %.2f s until the launcher lost focus (prefetch on, %d files, %.1f MB advised)",
+                 seconds, prefetch.files, prefetch.bytes_advised / (1024.0 * 1024.0));
+    }
+    else
+    {
+        snprintf(report, sizeof(report), "Last launch: %.2f s until the launcher lost focus (prefetch off)", seconds);
+    }
+    last_launch_report = report;
+}
 
-    while (!done)
+// Handle pending SDL events. Returns false once the window is closing.
+bool process_events()
+{
+    bool done = false;
+    SDL_Event event;
+    while (SDL_PollEvent(&event))
     {
-        SDL_Event event;
-        while (SDL_PollEvent(&event))
+        ImGui_ImplSDL2_ProcessEvent(&event);
+        switch (event.type)
         {
-            ImGui_ImplSDL2_ProcessEvent(&event);
-            switch (event.type)
+        case SDL_QUIT:
+            // Save current window size before quitting
+            int current_width, current_height;
+            SDL_GetWindowSize(window, &current_width, &current_height);
+            if (validate_window_size(current_width, current_height))
             {
-            case SDL_QUIT:
-                // Save current window size before quitting
+                config["resolution"] = {current_width, current_height};
+                mark_config_dirty();
+            }
+            done = true;
+            break;
+        case SDL_WINDOWEVENT:
+            if (event.window.event == SDL_WINDOWEVENT_CLOSE && event.window.windowID == SDL_GetWindowID(window))
+            {
+                // Save current window size before closing
                 int current_width, current_height;
                 SDL_GetWindowSize(window, &current_width, &current_height);
-                if (validate_window_size(current_width, current_height))
+                if (current_width >= 400 && current_height >= 300 && current_width <= 4096 && current_height <= 4096)
                 {
                     config["resolution"] = {current_width, current_height};
-                    write_config_file(get_config_file_path(), config);
+                    mark_config_dirty();
                 }
                 done = true;
-                break;
-            case SDL_WINDOWEVENT:
-                if (event.window.event == SDL_WINDOWEVENT_CLOSE && event.window.windowID == SDL_GetWindowID(window))
-                {
-                    // Save current window size before closing
-                    int current_width, current_height;
-                    SDL_GetWindowSize(window, &current_width, &current_height);
-                    if (current_width >= 400 && current_height >= 300 && current_width <= 4096 && current_height <= 4096)
-                    {
-                        config["resolution"] = {current_width, current_height};
-                        write_config_file(get_config_file_path(), config);
-                    }
-                    done = true;
-                }
-                if (event.window.event == SDL_WINDOWEVENT_RESIZED)
-                {
-                    configure_color_buffer();
-                    // Update the configuration with the new size
-                    int newWidth = event.window.data1;
-                    int newHeight = event.window.data2;
+            }
+            if (event.window.event == SDL_WINDOWEVENT_FOCUS_LOST && awaiting_game_window && game_running &&
+                std::chrono::steady_clock::now() - launch_start >= GAME_WINDOW_MIN_DELAY)
+            {
+                finish_launch_timing();
+            }
+            if (event.window.event == SDL_WINDOWEVENT_RESIZED)
+            {
+                configure_color_buffer();
+                // Update the configuration with the new size
+                int newWidth = event.window.data1;
+                int newHeight = event.window.data2;
 
-                    // Validate the new size before saving
-                    if (validate_window_size(newWidth, newHeight))
-                    {
-                        config["resolution"] = {newWidth, newHeight};
-                        // Save will happen on app exit to avoid frequent file writes during resize
-                    }
-                }
-                break;
-            case SDL_DROPFILE:
-                if (event.drop.file != nullptr)
+                // Validate the new size before saving
+                if (validate_window_size(newWidth, newHeight))
                 {
-                    process_dropped_item(event.drop.file);
-                    SDL_free(event.drop.file);
+                    config["resolution"] = {newWidth, newHeight};
+                    // Save will happen on app exit to avoid frequent file writes during resize
                 }
-                break;
             }
+            break;
+        case SDL_DROPFILE:
+            if (event.drop.file != nullptr)
+            {
+                process_dropped_item(event.drop.file);
+                SDL_free(event.drop.file);
+            }
+            break;
         }
+    }
+    return !done;
+}
+
+// Notice the game exiting and restore background I/O
+void poll_game_process()
+{
+    if (!game_running || game_process.running())
+    {
+        return;
+    }
+    game_running = false;
+    set_background_io_mode(BackgroundIoMode::Normal);
+    record_trace_span("launch", launch_start, std::chrono::steady_clock::now());
 
-        // Start the Dear ImGui frame
-        ImGui_ImplSDLRenderer2_NewFrame();
-        ImGui_ImplSDL2_NewFrame();
-        ImGui::NewFrame();
+    if (awaiting_game_window)
+    {
+        awaiting_game_window = false;
+        last_launch_report = "Last launch: the game exited before the launcher lost focus, so it was not timed";
+    }
+}
 
-        ImGui::SetNextWindowBgAlpha(0.0f);
+// Build, render and present one frame, then run the per-frame bookkeeping
+void render_frame()
+{
+    ImGuiIO &io = ImGui::GetIO();
+    begin_profiler_frame();
+    begin_allocation_frame();
 
-        ImVec2 screenSize = io.DisplaySize;
-        ImGui::SetNextWindowPos(ImVec2(0, 0));
-        ImGui::SetNextWindowSize(screenSize);
+    // Start the Dear ImGui frame
+    ImGui_ImplSDLRenderer2_NewFrame();
+    ImGui_ImplSDL2_NewFrame();
+    ImGui::NewFrame();
 
+    ImGui::SetNextWindowBgAlpha(0.0f);
+
+    ImVec2 screenSize = io.DisplaySize;
+    ImGui::SetNextWindowPos(ImVec2(0, 0));
+    ImGui::SetNextWindowSize(screenSize);
+
+    {
+        AllocationScope allocation_scope("show_ui");
         show_ui();
+    }
 
-        ImGui::End();
+    ImGui::End();
+
+    show_profiler_overlay();
 
-        // Rendering
+    // Rendering
+    {
+        ScopedStageTimer timer(FrameStage::ImGuiRender);
+        AllocationScope allocation_scope("imgui_render");
         ImGui::Render();
-        SDL_RenderSetScale(renderer, io.DisplayFramebufferScale.x, io.DisplayFramebufferScale.y);
-        SDL_SetRenderDrawColor(renderer, (Uint8)(clear_color.x * 255), (Uint8)(clear_color.y * 255),
-                               (Uint8)(clear_color.z * 255), (Uint8)(clear_color.w * 255));
-        SDL_RenderClear(renderer);
+    }
+    SDL_RenderSetScale(renderer, io.DisplayFramebufferScale.x, io.DisplayFramebufferScale.y);
+    SDL_SetRenderDrawColor(renderer, (Uint8)(clear_color.x * 255), (Uint8)(clear_color.y * 255),
+                           (Uint8)(clear_color.z * 255), (Uint8)(clear_color.w * 255));
+    SDL_RenderClear(renderer);
 
-        // Only show fire animation in fire theme
-        if (config["theme"] == "fire")
-        {
-            draw_fire(color_buffer_texture, color_buffer, color_buffer_width, color_buffer_height);
-            SDL_RenderCopy(renderer, color_buffer_texture, NULL, NULL);
-        }
+    // Only show fire animation in fire theme
+    if (config_string("theme") == "fire")
+    {
+        ScopedStageTimer timer(FrameStage::Fire);
+        AllocationScope allocation_scope("fire");
+        draw_fire(color_buffer_texture, color_buffer, color_buffer_width, color_buffer_height);
+        SDL_RenderCopy(renderer, color_buffer_texture, NULL, NULL);
+    }
 
+    {
+        ScopedStageTimer timer(FrameStage::ImGuiRender);
+        AllocationScope allocation_scope("imgui_render");
         ImGui_ImplSDLRenderer2_RenderDrawData(ImGui::GetDrawData());
+    }
+    {
+        ScopedStageTimer timer(FrameStage::Present);
+        AllocationScope allocation_scope("present");
         SDL_RenderPresent(renderer);
     }
+
+    {
+        AllocationScope allocation_scope("frame_bookkeeping");
+        task_scheduler->drain_main_thread_queue();
+        frame_jobs.run(FRAME_JOB_BUDGET);
+        update_startup_phases();
+        poll_game_process();
+        poll_pwad_scan();
+        flush_config_if_dirty();
+    }
+    end_allocation_frame();
+    end_profiler_frame();
+}
+
+void update()
+{
+    bool running = true;
+    while (running)
+    {
+        running = process_events();
+        render_frame();
+        if (game_running)
+        {
+            SDL_Delay(100); // A few frames a second is plenty behind a running game
+        }
+    }
 }
 
 void setup_config_file()
 {
+    TraceScope trace("setup_config_file");
     std::string config_file_path = get_config_file_path();
     bool loaded = read_config_file(config_file_path, config);
 
     // Run migrations after loading config
-    config = migrate_config(config);
-    write_config_file(config_file_path, config);
+    {
+        TraceScope trace("migrate_config");
+        config = migrate_config(config);
+    }
 
     assert(loaded == true);
 
@@ -1779,6 +2818,67 @@ void setup_config_file()
         config["sdl_renderer_inherit"] = false;
     }
 
+    // Ensure profiles field exists with default value
+    if (!config.contains("profiles") || !config["profiles"].is_object())
+    {
+        config["profiles"] = nlohmann::json::object();
+    }
+
+    // Ensure active_profile field exists with default value
+    if (!config.contains("active_profile") || config["active_profile"].is_null())
+    {
+        config["active_profile"] = "";
+    }
+
+    // Ensure pwad_directory_options field exists with default value
+    if (!config.contains("pwad_directory_options") || !config["pwad_directory_options"].is_object())
+    {
+        config["pwad_directory_options"] = nlohmann::json::object();
+    }
+
+    // Ensure prefetch_selected_files field exists with default value
+    if (!config.contains("prefetch_selected_files") || config["prefetch_selected_files"].is_null())
+    {
+        config["prefetch_selected_files"] = true;
+    }
+
+    // Ensure prefetch_budget_mb field exists with default value
+    if (!config.contains("prefetch_budget_mb") || config["prefetch_budget_mb"].is_null())
+    {
+        config["prefetch_budget_mb"] = 1024;
+    }
+
+    // Ensure network_revalidate_minutes field exists with default value
+    if (!config.contains("network_revalidate_minutes") || !config["network_revalidate_minutes"].is_number_integer())
+    {
+        config["network_revalidate_minutes"] = 10;
+    }
+
+    // Ensure network_max_requests field exists with default value
+    if (!config.contains("network_max_requests") || !config["network_max_requests"].is_number_integer())
+    {
+        config["network_max_requests"] = 16;
+    }
+
+    // Ensure background_io_while_playing field exists with default value
+    if (!config.contains("background_io_while_playing") || !config["background_io_while_playing"].is_string())
+    {
+        config["background_io_while_playing"] = "low_priority";
+    }
+
+    // Ensure measure_launch_time field exists with default value
+    if (!config.contains("measure_launch_time") || config["measure_launch_time"].is_null())
+    {
+        config["measure_launch_time"] = false;
+    }
+
+    // Ensure show_profiler_overlay field exists with default value
+    if (!config.contains("show_profiler_overlay") || config["show_profiler_overlay"].is_null())
+    {
+        config["show_profiler_overlay"] = false;
+    }
+    set_frame_profiler_enabled(config["show_profiler_overlay"].get<bool>());
+
     // Update the selected_font_scale_index to match the loaded font scale
     static const std::vector<float> font_scales = {0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f,
                                                    1.0f, 1.1f, 1.2f, 1.3f, 1.4f, 1.5f, 1.6f, 1.7f,
@@ -1793,8 +2893,8 @@ void setup_config_file()
         }
     }
 
-    // Save the config after all initializations
-    write_config_file(config_file_path, config);
+    // Save the config after all initializations, once the first frame is on screen
+    mark_config_dirty();
 
     std::sort(config["iwads"].begin(), config["iwads"].end(),
               [](const std::string &a, const std::string &b)
@@ -1820,6 +2920,9 @@ int setup()
 {
     SDL_SetMainReady();
 
+    startup_begin = std::chrono::steady_clock::now();
+    TraceScope trace("setup");
+
     // Setup SDL
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER | SDL_INIT_GAMECONTROLLER) != 0)
     {
@@ -1914,7 +3017,30 @@ int setup()
     // Set font scale from config (loaded earlier in setup_config_file)
     io.FontGlobalScale = config["font_scale"].get<float>();
 
-    // Configure file dialogs with appropriate filters and flags BEFORE using them
+    // Apply initial theme
+    apply_theme(config["theme"].get<std::string>());
+
+    // Marks this as the UI thread, which background I/O throttling never applies to
+    set_background_io_mode(BackgroundIoMode::Normal);
+
+    task_scheduler = std::make_unique<TaskScheduler>();
+
+    // File dialog listings share the worker pool, so clean_up() joins them with everything else
+    ImGui::FileBrowser::SetListingRunner([](std::function<void()> listing)
+                                         { task_scheduler->submit(std::move(listing), TaskPriority::Interactive); });
+    ImGui::FileBrowser::SetListingCheckpoint(background_io_checkpoint);
+
+    // The PWAD list fills in once the scan finishes; the window shows a placeholder until then
+    start_pwad_scan_async();
+
+    return 0;
+}
+
+// Configure file dialogs with appropriate filters and flags BEFORE using them.
+// SetPwd() lists a directory, so this runs after the first frame instead of during setup.
+void configure_file_dialogs()
+{
+    TraceScope trace("configure_file_dialogs");
     iwad_file_dialog.SetTitle("Select IWAD");
     iwad_file_dialog.SetTypeFilters(WAD_EXTENSIONS);
 #ifdef __APPLE__
@@ -1932,18 +3058,53 @@ int setup()
     gzdoom_file_dialog.SetTitle("Select Doom Executable");
     gzdoom_file_dialog.SetTypeFilters(EXECUTABLE_EXTENSIONS);
 
-    // Now populate lists (config was already set up earlier)
-    populate_pwad_list();
+    file_dialogs_configured = true;
+}
 
-    // Apply initial theme
-    apply_theme(config["theme"].get<std::string>());
+double milliseconds_since_startup()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startup_begin).count();
+}
 
-    return 0;
+// Finish the startup work deferred past the first frame and record the startup phase timings
+void update_startup_phases()
+{
+    if (time_to_interactive_ms >= 0.0)
+    {
+        return;
+    }
+
+    if (time_to_first_frame_ms < 0.0)
+    {
+        time_to_first_frame_ms = milliseconds_since_startup();
+        record_trace_span("time_to_first_frame", startup_begin, std::chrono::steady_clock::now());
+        return;
+    }
+
+    if (!file_dialogs_configured)
+    {
+        configure_file_dialogs();
+    }
+
+    if (!pwad_scan_pending)
+    {
+        time_to_interactive_ms = milliseconds_since_startup();
+        record_trace_span("time_to_interactive", startup_begin, std::chrono::steady_clock::now());
+    }
 }
 
 void clean_up()
 {
-    bool written = write_config_file(get_config_file_path(), config);
+    set_background_io_mode(BackgroundIoMode::Normal); // Release suspended workers so they can be joined
+    pwad_scan_token.cancel();
+    // Join the workers while task_scheduler is still set, since a running scan posts its result through it. This
+    // also lets any config save already running finish.
+    ImGui::FileBrowser::SetListingRunner(nullptr);
+    task_scheduler->shutdown();
+    task_scheduler.reset();
+    shutdown_prefetch();
+
+    bool written = config_store.save(get_config_file_path(), *config_store.commit(config));
     assert(written == true);
 
     ImGui_ImplSDLRenderer2_Shutdown();
@@ -1955,11 +3116,40 @@ void clean_up()
     SDL_Quit();
 }
 
+// The render harness links this file with its own main()
+#ifndef JUST_LAUNCH_DOOM_NO_MAIN
 int main(int argc, char **argv)
 {
+    // Shortcuts and scripts can launch straight into the game without creating a window
+    CliOptions cli_options = parse_cli_args(argc, argv);
+    if (!cli_options.trace.empty())
+    {
+        if (!start_trace(cli_options.trace))
+        {
+            std::cerr << "Could not open trace file: " << cli_options.trace << std::endl;
+        }
+        set_trace_thread_name("main");
+        ImGui::FileBrowser::SetListingTimingHook([](std::chrono::steady_clock::time_point begin,
+                                                    std::chrono::steady_clock::time_point end)
+                                                 { record_trace_span("file_dialog_listing", begin, end); });
+    }
+
+    if (is_headless_run(cli_options))
+    {
+        int result = run_headless(cli_options);
+        stop_trace();
+        return result;
+    }
+
     setup();
     update();
     clean_up();
 
+    if (stop_trace())
+    {
+        std::cout << "[trace] written to " << cli_options.trace << std::endl;
+    }
+
     return 0;
-}
\ No newline at end of file
+}
+#endif
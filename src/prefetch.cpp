@@ -0,0 +1,173 @@
+#include "prefetch.h"
+#include "background_io.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    std::mutex prefetch_mutex;
+    std::condition_variable prefetch_cv;
+    std::thread prefetch_thread;
+    std::vector<std::string> last_requested;
+    std::chrono::steady_clock::time_point last_requested_at;
+    std::vector<std::string> pending_paths;
+    uint64_t pending_budget = 0;
+    bool has_pending = false;
+    bool stopping = false;
+    PrefetchStats stats;
+
+    void prefetch_worker()
+    {
+        std::unique_lock<std::mutex> lock(prefetch_mutex);
+        while (true)
+        {
+            prefetch_cv.wait(lock, []
+                             { return has_pending || stopping; });
+            if (stopping)
+            {
+                return;
+            }
+
+            std::vector<std::string> paths = std::move(pending_paths);
+            uint64_t budget = pending_budget;
+            has_pending = false;
+            stats.in_progress = true;
+            lock.unlock();
+
+            BackgroundJob job("Prefetch selected files");
+            auto start = std::chrono::steady_clock::now();
+            uint64_t advised = 0;
+            int files = 0;
+            for (const auto &path : paths)
+            {
+                background_io_checkpoint();
+                if (advised >= budget)
+                {
+                    break;
+                }
+                uint64_t bytes = prefetch_file(path, budget - advised);
+                if (bytes > 0)
+                {
+                    advised += bytes;
+                    files++;
+                }
+            }
+            double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            lock.lock();
+            stats.files = files;
+            stats.bytes_advised = advised;
+            stats.elapsed_ms = elapsed;
+            stats.in_progress = has_pending;
+        }
+    }
+}
+
+uint64_t prefetch_file(const std::string &path, uint64_t max_bytes)
+{
+#if defined(__linux__) || defined(__APPLE__)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return 0;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        close(fd);
+        return 0;
+    }
+
+    uint64_t length = std::min<uint64_t>(static_cast<uint64_t>(st.st_size), max_bytes);
+#ifdef __linux__
+    // WILLNEED starts asynchronous readahead and returns without waiting for the disk
+    posix_fadvise(fd, 0, static_cast<off_t>(length), POSIX_FADV_WILLNEED);
+#else
+    // F_RDADVISE takes an int count, so issue the advice in chunks
+    const uint64_t chunk = 64ull * 1024 * 1024;
+    for (uint64_t offset = 0; offset < length; offset += chunk)
+    {
+        struct radvisory advice;
+        advice.ra_offset = static_cast<off_t>(offset);
+        advice.ra_count = static_cast<int>(std::min(chunk, length - offset));
+        fcntl(fd, F_RDADVISE, &advice);
+    }
+#endif
+    close(fd);
+    return length;
+#else
+    // No readahead hint available, so warm the cache by reading the file
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return 0;
+    }
+
+    std::vector<char> buffer(1024 * 1024);
+    uint64_t total = 0;
+    while (total < max_bytes)
+    {
+        file.read(buffer.data(), buffer.size());
+        std::streamsize read = file.gcount();
+        if (read <= 0)
+        {
+            break;
+        }
+        total += static_cast<uint64_t>(read);
+    }
+    return std::min(total, max_bytes);
+#endif
+}
+
+void prefetch_files(const std::vector<std::string> &paths, uint64_t byte_budget)
+{
+    std::lock_guard<std::mutex> lock(prefetch_mutex);
+    auto now = std::chrono::steady_clock::now();
+    if (stopping || (paths == last_requested && now - last_requested_at < PREFETCH_REPEAT_INTERVAL))
+    {
+        return;
+    }
+
+    last_requested = paths;
+    last_requested_at = now;
+    pending_paths = paths;
+    pending_budget = byte_budget;
+    has_pending = true;
+    stats.in_progress = true;
+
+    if (!prefetch_thread.joinable())
+    {
+        prefetch_thread = std::thread(prefetch_worker);
+    }
+    prefetch_cv.notify_one();
+}
+
+PrefetchStats get_prefetch_stats()
+{
+    std::lock_guard<std::mutex> lock(prefetch_mutex);
+    return stats;
+}
+
+void shutdown_prefetch()
+{
+    {
+        std::lock_guard<std::mutex> lock(prefetch_mutex);
+        stopping = true;
+    }
+    prefetch_cv.notify_one();
+    if (prefetch_thread.joinable())
+    {
+        prefetch_thread.join();
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct PrefetchStats
+{
+    int files = 0;                // Files advised in the last completed request
+    uint64_t bytes_advised = 0;   // Bytes handed to the OS for readahead
+    double elapsed_ms = 0.0;      // Time spent issuing the advice
+    bool in_progress = false;     // True while the worker is still busy
+};
+
+// Warm the page cache for a single file, advising at most max_bytes. Returns the number of bytes advised.
+uint64_t prefetch_file(const std::string &path, uint64_t max_bytes);
+
+// The same list is advised again once this much time has passed, since its pages may have been evicted meanwhile
+const std::chrono::seconds PREFETCH_REPEAT_INTERVAL(30);
+
+// Queue a background readahead of the given files, stopping once byte_budget bytes have been advised.
+// Asking again for the same list within PREFETCH_REPEAT_INTERVAL is a no-op, so this is cheap enough to call
+// every frame.
+void prefetch_files(const std::vector<std::string> &paths, uint64_t byte_budget);
+
+PrefetchStats get_prefetch_stats();
+void shutdown_prefetch();
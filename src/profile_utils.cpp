@@ -0,0 +1,63 @@
+#include "profile_utils.h"
+
+const std::vector<std::string> PROFILE_FIELDS = {
+    "selected_executable", "selected_iwad", "selected_pwads", "selected_config", "custom_params"};
+
+void save_profile(nlohmann::json &config, const std::string &name)
+{
+    if (!config.contains("profiles") || !config["profiles"].is_object())
+    {
+        config["profiles"] = nlohmann::json::object();
+    }
+
+    nlohmann::json profile = nlohmann::json::object();
+    for (const auto &field : PROFILE_FIELDS)
+    {
+        if (config.contains(field))
+        {
+            profile[field] = config[field];
+        }
+    }
+    config["profiles"][name] = std::move(profile);
+}
+
+bool apply_profile(nlohmann::json &config, const std::string &name)
+{
+    if (!config.contains("profiles") || !config["profiles"].contains(name))
+    {
+        return false;
+    }
+
+    const nlohmann::json &profile = config["profiles"][name];
+    for (const auto &field : PROFILE_FIELDS)
+    {
+        // Fields missing from older profiles keep their current value
+        if (profile.contains(field))
+        {
+            config[field] = profile[field];
+        }
+    }
+    return true;
+}
+
+bool delete_profile(nlohmann::json &config, const std::string &name)
+{
+    if (!config.contains("profiles") || !config["profiles"].is_object())
+    {
+        return false;
+    }
+    return config["profiles"].erase(name) > 0;
+}
+
+std::vector<std::string> get_profile_names(const nlohmann::json &config)
+{
+    std::vector<std::string> names;
+    if (config.contains("profiles") && config["profiles"].is_object())
+    {
+        for (const auto &[name, profile] : config["profiles"].items())
+        {
+            names.push_back(name);
+        }
+    }
+    return names;
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "nlohmann/json.hpp"
+
+// Config fields captured by a launch profile
+extern const std::vector<std::string> PROFILE_FIELDS;
+
+// Store the current selection under config["profiles"][name], replacing any existing profile with that name
+void save_profile(nlohmann::json &config, const std::string &name);
+
+// Copy a stored profile back into the selection fields. Returns false if the profile does not exist.
+bool apply_profile(nlohmann::json &config, const std::string &name);
+
+bool delete_profile(nlohmann::json &config, const std::string &name);
+std::vector<std::string> get_profile_names(const nlohmann::json &config);
@@ -0,0 +1,338 @@
+#include "pwad_index.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <sys/mount.h>
+#include <sys/param.h>
+#elif defined(__linux__)
+#include <sys/vfs.h>
+#endif
+
+namespace
+{
+#ifdef __linux__
+    struct FilesystemMagic
+    {
+        unsigned long magic;
+        const char *type;
+        bool network;
+    };
+
+    // f_type values from linux/magic.h and the filesystems' own headers
+    const FilesystemMagic FILESYSTEM_MAGICS[] = {
+        {0x6969, "nfs", true},
+        {0x517B, "smb", true},
+        {0xFF534D42, "cifs", true},
+        {0xFE534D42, "smb2", true},
+        {0x73757245, "coda", true},
+        {0x5346414F, "afs", true},
+        {0x6B414653, "afs", true},
+        {0x01021997, "9p", true},
+        {0x00C36400, "ceph", true},
+        {0x65735546, "fuse", true}, // sshfs, rclone and the like; a local FUSE disk only loses some freshness
+        {0xEF53, "ext4", false},
+        {0x58465342, "xfs", false},
+        {0x9123683E, "btrfs", false},
+        {0x2FC12FC1, "zfs", false},
+        {0x01021994, "tmpfs", false},
+        {0x794C7630, "overlay", false},
+        {0x4D44, "vfat", false},
+        {0x2011BAB0, "exfat", false},
+        {0x5346544E, "ntfs", false},
+        {0xF2F52010, "f2fs", false},
+    };
+#endif
+
+    nlohmann::json root_settings(const PwadScanRoot &root)
+    {
+        return {{"recursive", root.recursive}, {"max_depth", root.max_depth}, {"exclude", root.exclude}};
+    }
+
+    int64_t seconds_since_epoch()
+    {
+        return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
+    double milliseconds_since(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Serializes updates to the index file. A superseded background scan can still be finishing while a newer scan
+    // or a synchronous reload writes the same file.
+    std::mutex index_file_mutex;
+}
+
+FilesystemInfo detect_filesystem(const std::string &directory)
+{
+    FilesystemInfo info;
+#ifdef _WIN32
+    if (directory.rfind("\\\\", 0) == 0 || directory.rfind("//", 0) == 0)
+    {
+        info.kind = FilesystemKind::Network;
+        info.type = "unc";
+        return info;
+    }
+    std::string root = std::filesystem::path(directory).root_path().string();
+    if (!root.empty())
+    {
+        UINT drive_type = GetDriveTypeA(root.c_str());
+        info.kind = drive_type == DRIVE_REMOTE ? FilesystemKind::Network : FilesystemKind::Local;
+        info.type = drive_type == DRIVE_REMOTE ? "remote" : drive_type == DRIVE_REMOVABLE ? "removable" : "fixed";
+    }
+#elif defined(__APPLE__)
+    struct statfs st;
+    if (statfs(directory.c_str(), &st) == 0)
+    {
+        info.type = st.f_fstypename;
+        info.kind = (st.f_flags & MNT_LOCAL) ? FilesystemKind::Local : FilesystemKind::Network;
+    }
+#elif defined(__linux__)
+    struct statfs st;
+    if (statfs(directory.c_str(), &st) == 0)
+    {
+        unsigned long magic = static_cast<unsigned long>(st.f_type) & 0xFFFFFFFFul;
+        for (const auto &known : FILESYSTEM_MAGICS)
+        {
+            if (known.magic == magic)
+            {
+                info.type = known.type;
+                info.kind = known.network ? FilesystemKind::Network : FilesystemKind::Local;
+                return info;
+            }
+        }
+        char hex[16];
+        snprintf(hex, sizeof(hex), "0x%lx", magic);
+        info.type = hex;
+    }
+#endif
+    return info;
+}
+
+bool PwadIndex::load(const std::string &path)
+{
+    entries_ = nlohmann::json::object();
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    try
+    {
+        nlohmann::json data;
+        file >> data;
+        if (data.value("version", 0) == 1 && data.contains("roots") && data["roots"].is_object())
+        {
+            entries_ = std::move(data["roots"]);
+            return true;
+        }
+    }
+    catch (const std::exception &)
+    {
+    }
+    return false;
+}
+
+bool PwadIndex::save(const std::string &path) const
+{
+    std::error_code ec;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty())
+    {
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary);
+        if (!file.is_open())
+        {
+            return false;
+        }
+        file << nlohmann::json{{"version", 1}, {"roots", entries_}}.dump();
+        if (!file.good())
+        {
+            return false;
+        }
+    }
+    std::filesystem::rename(temporary, path, ec);
+    return !ec;
+}
+
+const nlohmann::json *PwadIndex::find(const PwadScanRoot &root) const
+{
+    auto it = entries_.find(root.directory);
+    if (it == entries_.end() || !it->is_object() || !it->contains("files") || !(*it)["files"].is_array())
+    {
+        return nullptr;
+    }
+    // Entries scanned with other settings (say before recursion was turned on) do not count
+    if (!it->contains("settings") || (*it)["settings"] != root_settings(root))
+    {
+        return nullptr;
+    }
+    return &*it;
+}
+
+bool PwadIndex::contains(const PwadScanRoot &root) const
+{
+    return find(root) != nullptr;
+}
+
+void PwadIndex::get(const PwadScanRoot &root, PwadList &result) const
+{
+    const nlohmann::json *entry = find(root);
+    if (!entry)
+    {
+        return;
+    }
+    // Each file is [path, txt_path, size, mtime]; size and mtime are null when unknown
+    for (const auto &file : (*entry)["files"])
+    {
+        if (!file.is_array() || file.size() != 4 || !file[0].is_string() || !file[1].is_string())
+        {
+            continue;
+        }
+        result.add(root.directory, file[0].get_ref<const std::string &>(), file[1].get_ref<const std::string &>());
+        if (file[2].is_number_unsigned() && file[3].is_number_integer())
+        {
+            result.set_metadata(result.size() - 1, file[2].get<uint64_t>(), file[3].get<int64_t>());
+        }
+    }
+}
+
+void PwadIndex::put(const PwadScanRoot &root, const PwadList &scanned, int64_t indexed_at)
+{
+    nlohmann::json files = nlohmann::json::array();
+    for (size_t i = 0; i < scanned.size(); i++)
+    {
+        if (scanned.directory(i) != root.directory)
+        {
+            continue;
+        }
+        nlohmann::json size = nullptr;
+        nlohmann::json mtime = nullptr;
+        if (scanned.has_metadata(i))
+        {
+            size = scanned.file_size(i);
+            mtime = scanned.modified_time(i);
+        }
+        files.push_back({scanned.filepath(i), scanned.txt_filepath(i), size, mtime});
+    }
+    entries_[root.directory] = {{"settings", root_settings(root)}, {"indexed_at", indexed_at}, {"files", std::move(files)}};
+}
+
+int64_t PwadIndex::indexed_at(const PwadScanRoot &root) const
+{
+    const nlohmann::json *entry = find(root);
+    return entry ? entry->value("indexed_at", int64_t(0)) : 0;
+}
+
+void PwadIndex::retain(const std::vector<PwadScanRoot> &roots)
+{
+    for (auto it = entries_.begin(); it != entries_.end();)
+    {
+        bool registered = false;
+        for (const auto &root : roots)
+        {
+            registered = registered || root.directory == it.key();
+        }
+        it = registered ? std::next(it) : entries_.erase(it);
+    }
+}
+
+PwadIndexedScan scan_pwad_roots_indexed(const std::vector<PwadScanRoot> &roots, const PwadScanPolicy &policy)
+{
+    PwadIndexedScan scan;
+    scan.listings.resize(roots.size());
+    scan.roots.resize(roots.size());
+
+    PwadIndex index;
+    if (!policy.index_path.empty())
+    {
+        std::lock_guard<std::mutex> lock(index_file_mutex);
+        index.load(policy.index_path);
+    }
+
+    // Sort the roots into those served from the index and the local and network ones to scan live
+    std::vector<size_t> local_roots;
+    std::vector<size_t> network_roots;
+    std::vector<bool> indexed(roots.size(), false);
+    for (size_t r = 0; r < roots.size(); r++)
+    {
+        PwadRootStatus &status = scan.roots[r];
+        status.directory = roots[r].directory;
+        status.filesystem = detect_filesystem(roots[r].directory);
+        bool network = status.filesystem.kind == FilesystemKind::Network;
+        indexed[r] = !policy.index_path.empty() && (network || policy.index_local_roots);
+
+        if (indexed[r] && policy.prefer_index && index.contains(roots[r]))
+        {
+            auto started = std::chrono::steady_clock::now();
+            index.get(roots[r], scan.listings[r]);
+            scan.listings[r].shrink_to_fit();
+            status.files = scan.listings[r].size();
+            status.milliseconds = milliseconds_since(started);
+            status.from_index = true;
+            status.indexed_at = index.indexed_at(roots[r]);
+            scan.served_from_index = true;
+            continue;
+        }
+        (network ? network_roots : local_roots).push_back(r);
+    }
+
+    std::vector<size_t> reindexed;
+    for (const auto *group : {&local_roots, &network_roots})
+    {
+        if (group->empty())
+        {
+            continue;
+        }
+        std::vector<PwadScanRoot> group_roots;
+        for (size_t r : *group)
+        {
+            group_roots.push_back(roots[r]);
+        }
+
+        std::vector<PwadRootScanStats> stats;
+        std::vector<PwadList> scanned =
+            scan_pwad_root_listings(group_roots, group == &network_roots ? policy.network : policy.local, &stats);
+        int64_t now = seconds_since_epoch();
+        for (size_t g = 0; g < group->size(); g++)
+        {
+            size_t r = (*group)[g];
+            scan.listings[r] = std::move(scanned[g]);
+            scan.roots[r].files = stats[g].files;
+            scan.roots[r].milliseconds = stats[g].milliseconds;
+            // An unreachable share keeps its old entry rather than being indexed as empty
+            if (indexed[r] && stats[g].found)
+            {
+                scan.roots[r].indexed_at = now;
+                reindexed.push_back(r);
+            }
+        }
+    }
+
+    if (!reindexed.empty())
+    {
+        // Reload under the lock and apply only this scan's roots, so a write that landed since the load is kept
+        std::lock_guard<std::mutex> lock(index_file_mutex);
+        PwadIndex latest;
+        latest.load(policy.index_path);
+        for (size_t r : reindexed)
+        {
+            latest.put(roots[r], scan.listings[r], scan.roots[r].indexed_at);
+        }
+        latest.retain(roots);
+        latest.save(policy.index_path);
+    }
+
+    return scan;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "nlohmann/json.hpp"
+#include "pwad_list.h"
+#include "pwad_scan.h"
+
+enum class FilesystemKind
+{
+    Local,
+    Network // NFS, SMB/CIFS, AFS, 9P, Ceph, FUSE (sshfs, rclone), mapped network drives
+};
+
+struct FilesystemInfo
+{
+    FilesystemKind kind = FilesystemKind::Local;
+    std::string type; // "ext4", "nfs", "cifs", ...; empty if it could not be determined
+};
+
+// Which filesystem a directory lives on (statfs on Linux and macOS, the drive type on Windows).
+// Can block for a long time on an unresponsive network mount, so keep it off the UI thread.
+FilesystemInfo detect_filesystem(const std::string &directory);
+
+// Scan results for slow roots, persisted between runs so the list can be shown before the network answers.
+// Entries are keyed by directory and remember the root settings they were scanned with.
+class PwadIndex
+{
+public:
+    // A missing or unreadable file leaves the index empty
+    bool load(const std::string &path);
+    // Writes to a temporary file and renames it over path, so a crash never leaves half an index
+    bool save(const std::string &path) const;
+
+    bool contains(const PwadScanRoot &root) const;
+    // The indexed files of root, recorded under root.directory
+    void get(const PwadScanRoot &root, PwadList &result) const;
+    // Replace the entry for root with the records of scanned that belong to it
+    void put(const PwadScanRoot &root, const PwadList &scanned, int64_t indexed_at);
+    int64_t indexed_at(const PwadScanRoot &root) const;
+    // Drop entries for directories that are no longer registered
+    void retain(const std::vector<PwadScanRoot> &roots);
+
+private:
+    const nlohmann::json *find(const PwadScanRoot &root) const;
+
+    nlohmann::json entries_ = nlohmann::json::object();
+};
+
+struct PwadScanPolicy
+{
+    PwadScanOptions local;   // Options for roots on local disks
+    PwadScanOptions network; // Options for network roots, usually with fewer requests in flight
+    bool prefer_index = true;        // Serve indexed roots from the index instead of scanning them
+    bool index_local_roots = false;  // Index local roots too; they normally scan fast enough not to need it
+    std::string index_path;          // Where the index lives; empty disables it
+};
+
+// How one root was last listed, for the settings view
+struct PwadRootStatus
+{
+    std::string directory;
+    FilesystemInfo filesystem;
+    size_t files = 0;
+    double milliseconds = 0.0; // Scan time, or the index lookup time when served from the index
+    bool from_index = false;
+    int64_t indexed_at = 0;    // Seconds since the epoch when the index entry was written, or 0
+};
+
+struct PwadIndexedScan
+{
+    std::vector<PwadList> listings;    // One per root, in the order of the roots passed in
+    std::vector<PwadRootStatus> roots; // Likewise
+    bool served_from_index = false;    // Some roots came from the index and still need a live scan
+};
+
+// Scan roots under policy: network roots are served from the index when allowed, everything else is scanned
+// live, and live results for indexed roots are written back to the index. Runs on a worker thread.
+PwadIndexedScan scan_pwad_roots_indexed(const std::vector<PwadScanRoot> &roots, const PwadScanPolicy &policy);
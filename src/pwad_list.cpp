@@ -0,0 +1,146 @@
+#include "pwad_list.h"
+
+void PwadList::add(const std::string &directory, std::string_view path, std::string_view txt_path)
+{
+    size_t separator = path.find_last_of("/\\");
+    size_t name_start = separator == std::string_view::npos ? 0 : separator + 1;
+
+    uint32_t path_offset = append_string(path);
+    path_offsets_.push_back(path_offset);
+    name_offsets_.push_back(path_offset + static_cast<uint32_t>(name_start));
+    txt_offsets_.push_back(txt_path.empty() ? NO_OFFSET : append_string(txt_path));
+    directory_indices_.push_back(intern_directory(directory));
+    flags_.push_back(0);
+    if (!sizes_.empty())
+    {
+        sizes_.push_back(0);
+        mtimes_.push_back(0);
+    }
+}
+
+void PwadList::append(const PwadList &other)
+{
+    // Offsets shift by the arena size; directory indices are re-interned
+    uint32_t base = static_cast<uint32_t>(arena_.size());
+    arena_.insert(arena_.end(), other.arena_.begin(), other.arena_.end());
+
+    std::vector<uint32_t> directory_map;
+    for (const auto &directory : other.directories_)
+    {
+        directory_map.push_back(intern_directory(directory));
+    }
+
+    for (size_t i = 0; i < other.size(); i++)
+    {
+        path_offsets_.push_back(base + other.path_offsets_[i]);
+        name_offsets_.push_back(base + other.name_offsets_[i]);
+        txt_offsets_.push_back(other.has_txt(i) ? base + other.txt_offsets_[i] : NO_OFFSET);
+        directory_indices_.push_back(directory_map[other.directory_indices_[i]]);
+        flags_.push_back(other.flags_[i]);
+    }
+
+    if (!other.sizes_.empty() || !sizes_.empty())
+    {
+        size_t first = size() - other.size();
+        sizes_.resize(size());
+        mtimes_.resize(size());
+        for (size_t i = 0; i < other.size(); i++)
+        {
+            sizes_[first + i] = other.file_size(i);
+            mtimes_[first + i] = other.modified_time(i);
+        }
+    }
+}
+
+void PwadList::reserve(size_t records, size_t arena_bytes)
+{
+    arena_.reserve(arena_bytes);
+    path_offsets_.reserve(records);
+    name_offsets_.reserve(records);
+    txt_offsets_.reserve(records);
+    directory_indices_.reserve(records);
+    flags_.reserve(records);
+}
+
+void PwadList::shrink_to_fit()
+{
+    arena_.shrink_to_fit();
+    path_offsets_.shrink_to_fit();
+    name_offsets_.shrink_to_fit();
+    txt_offsets_.shrink_to_fit();
+    directory_indices_.shrink_to_fit();
+    flags_.shrink_to_fit();
+    sizes_.shrink_to_fit();
+    mtimes_.shrink_to_fit();
+}
+
+void PwadList::clear()
+{
+    arena_.clear();
+    directories_.clear();
+    path_offsets_.clear();
+    name_offsets_.clear();
+    txt_offsets_.clear();
+    directory_indices_.clear();
+    flags_.clear();
+    sizes_.clear();
+    mtimes_.clear();
+}
+
+void PwadList::set_selected(size_t i, bool selected)
+{
+    flags_[i] = selected ? (flags_[i] | FLAG_SELECTED) : (flags_[i] & ~FLAG_SELECTED);
+}
+
+void PwadList::set_metadata(size_t i, uint64_t size, int64_t mtime)
+{
+    if (sizes_.empty())
+    {
+        sizes_.resize(this->size());
+        mtimes_.resize(this->size());
+    }
+    sizes_[i] = size;
+    mtimes_[i] = mtime;
+    flags_[i] |= FLAG_METADATA;
+}
+
+size_t PwadList::memory_bytes() const
+{
+    size_t bytes = arena_.capacity() + flags_.capacity() +
+                   sizes_.capacity() * sizeof(uint64_t) + mtimes_.capacity() * sizeof(int64_t) +
+                   (path_offsets_.capacity() + name_offsets_.capacity() + txt_offsets_.capacity() +
+                    directory_indices_.capacity()) *
+                       sizeof(uint32_t) +
+                   directories_.capacity() * sizeof(std::string);
+    for (const auto &directory : directories_)
+    {
+        bytes += directory.capacity() + 1;
+    }
+    return bytes;
+}
+
+uint32_t PwadList::append_string(std::string_view text)
+{
+    uint32_t offset = static_cast<uint32_t>(arena_.size());
+    arena_.insert(arena_.end(), text.begin(), text.end());
+    arena_.push_back('\0');
+    return offset;
+}
+
+uint32_t PwadList::intern_directory(const std::string &directory)
+{
+    // Files arrive grouped by directory, so the last one nearly always matches
+    if (!directories_.empty() && directories_.back() == directory)
+    {
+        return static_cast<uint32_t>(directories_.size() - 1);
+    }
+    for (size_t i = 0; i < directories_.size(); i++)
+    {
+        if (directories_[i] == directory)
+        {
+            return static_cast<uint32_t>(i);
+        }
+    }
+    directories_.push_back(directory);
+    return static_cast<uint32_t>(directories_.size() - 1);
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Scanned PWAD records in one packed store. Every path lives in a single character arena, directories are
+// interned so a folder's path is stored once, and the per-file fields are parallel arrays indexed by record.
+// Pointers returned by the accessors stay valid until the next add() or clear().
+class PwadList
+{
+public:
+    // Append a file found in directory; txt_path is empty when the file has no companion .txt
+    void add(const std::string &directory, std::string_view path, std::string_view txt_path);
+    // Append every record of other, e.g. a part of the list scanned on another thread
+    void append(const PwadList &other);
+    void reserve(size_t records, size_t arena_bytes);
+    // Drop the growth slack once a scan is complete
+    void shrink_to_fit();
+    void clear();
+
+    size_t size() const { return path_offsets_.size(); }
+    bool empty() const { return path_offsets_.empty(); }
+
+    const char *filepath(size_t i) const { return arena_.data() + path_offsets_[i]; }
+    const char *filename(size_t i) const { return arena_.data() + name_offsets_[i]; } // Points into filepath(i)
+    bool has_txt(size_t i) const { return txt_offsets_[i] != NO_OFFSET; }
+    const char *txt_filepath(size_t i) const { return has_txt(i) ? arena_.data() + txt_offsets_[i] : ""; }
+
+    uint32_t directory_index(size_t i) const { return directory_indices_[i]; }
+    const std::string &directory(size_t i) const { return directories_[directory_indices_[i]]; }
+    const std::vector<std::string> &directories() const { return directories_; }
+
+    bool selected(size_t i) const { return (flags_[i] & FLAG_SELECTED) != 0; }
+    void set_selected(size_t i, bool selected);
+
+    // File size and modification time, when the scan collected them (see PwadScanOptions::collect_metadata)
+    bool has_metadata(size_t i) const { return (flags_[i] & FLAG_METADATA) != 0; }
+    uint64_t file_size(size_t i) const { return has_metadata(i) ? sizes_[i] : 0; }
+    int64_t modified_time(size_t i) const { return has_metadata(i) ? mtimes_[i] : 0; }
+    void set_metadata(size_t i, uint64_t size, int64_t mtime);
+
+    // Heap bytes held by the store, for benchmarks
+    size_t memory_bytes() const;
+
+private:
+    static constexpr uint32_t NO_OFFSET = UINT32_MAX;
+    static constexpr uint8_t FLAG_SELECTED = 1;
+    static constexpr uint8_t FLAG_METADATA = 2;
+
+    uint32_t append_string(std::string_view text);
+    uint32_t intern_directory(const std::string &directory);
+
+    std::vector<char> arena_; // NUL-terminated strings back to back
+    std::vector<std::string> directories_;
+    std::vector<uint32_t> path_offsets_;
+    std::vector<uint32_t> name_offsets_;
+    std::vector<uint32_t> txt_offsets_;
+    std::vector<uint32_t> directory_indices_;
+    std::vector<uint8_t> flags_;
+    std::vector<uint64_t> sizes_;  // Empty until the first set_metadata(), then one per record
+    std::vector<int64_t> mtimes_;
+};
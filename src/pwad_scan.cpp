@@ -0,0 +1,556 @@
+#include "pwad_scan.h"
+#include "batch_stat.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+#ifdef __linux__
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Directories already scanned, by device and inode, shared by the workers of one scan
+    class VisitedDirectories
+    {
+    public:
+        // True the first time a directory is seen. Unreadable directories count as seen.
+        bool insert(const std::string &directory)
+        {
+#ifndef _WIN32
+            struct stat st;
+            if (stat(directory.c_str(), &st) != 0)
+            {
+                return false;
+            }
+            std::pair<uint64_t, uint64_t> id(static_cast<uint64_t>(st.st_dev), static_cast<uint64_t>(st.st_ino));
+#else
+            // No inode numbers through the standard library; the resolved path identifies the directory instead
+            std::error_code ec;
+            std::filesystem::path canonical = std::filesystem::canonical(directory, ec);
+            if (ec)
+            {
+                return false;
+            }
+            std::pair<uint64_t, uint64_t> id(0, std::hash<std::string>()(canonical.string()));
+#endif
+            std::lock_guard<std::mutex> lock(mutex_);
+            return visited_.insert(id).second;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::set<std::pair<uint64_t, uint64_t>> visited_;
+    };
+
+    bool is_excluded(const PwadScanRoot &root, std::string_view relative_path, std::string_view name)
+    {
+        return std::any_of(root.exclude.begin(), root.exclude.end(), [&](const std::string &pattern)
+                           { return glob_match(pattern, relative_path) || glob_match(pattern, name); });
+    }
+
+    enum class EntryType
+    {
+        Regular,
+        Directory,
+        Other
+    };
+
+    // Both listing backends call visit(name, type) per entry, with symlinks resolved to what they point at.
+    // They return false if the directory could not be opened.
+    template <typename Visit>
+    bool list_directory_std(const std::string &directory, Visit visit)
+    {
+        std::error_code ec;
+        auto it = std::filesystem::directory_iterator(directory, ec);
+        if (ec)
+        {
+            return false;
+        }
+        for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec))
+        {
+            std::error_code entry_ec;
+            EntryType type = it->is_regular_file(entry_ec) ? EntryType::Regular
+                             : it->is_directory(entry_ec)  ? EntryType::Directory
+                                                           : EntryType::Other;
+            visit(it->path().filename().string(), type);
+        }
+        return true;
+    }
+
+#ifdef __linux__
+    // Entry type for names whose d_type did not say (DT_UNKNOWN on some filesystems) or that are symlinks
+    EntryType stat_entry_type(int directory_fd, const char *name)
+    {
+        mode_t mode = 0;
+#ifdef STATX_TYPE
+        struct statx stx;
+        if (statx(directory_fd, name, AT_STATX_SYNC_AS_STAT, STATX_TYPE, &stx) == 0)
+        {
+            mode = stx.stx_mode;
+        }
+        else if (errno == ENOSYS)
+#endif
+        {
+            struct stat st;
+            if (fstatat(directory_fd, name, &st, 0) != 0)
+            {
+                return EntryType::Other;
+            }
+            mode = st.st_mode;
+        }
+        return S_ISREG(mode) ? EntryType::Regular : S_ISDIR(mode) ? EntryType::Directory
+                                                                  : EntryType::Other;
+    }
+
+    // Raw getdents64: one syscall returns a buffer full of entries with their d_type, and no per-entry
+    // allocation or stat happens unless the type is unknown
+    template <typename Visit>
+    bool list_directory_getdents(const std::string &directory, Visit visit)
+    {
+        int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct linux_dirent64
+        {
+            uint64_t d_ino;
+            int64_t d_off;
+            unsigned short d_reclen;
+            unsigned char d_type;
+            char d_name[];
+        };
+
+        alignas(linux_dirent64) char buffer[64 * 1024];
+        while (true)
+        {
+            long bytes = syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+            if (bytes <= 0)
+            {
+                break;
+            }
+            for (long offset = 0; offset < bytes;)
+            {
+                auto *entry = reinterpret_cast<linux_dirent64 *>(buffer + offset);
+                offset += entry->d_reclen;
+
+                const char *name = entry->d_name;
+                if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                {
+                    continue;
+                }
+
+                EntryType type = entry->d_type == DT_REG   ? EntryType::Regular
+                                 : entry->d_type == DT_DIR ? EntryType::Directory
+                                 : entry->d_type == DT_LNK || entry->d_type == DT_UNKNOWN
+                                     ? stat_entry_type(fd, name)
+                                     : EntryType::Other;
+                visit(std::string_view(name), type);
+            }
+        }
+        close(fd);
+        return true;
+    }
+#endif
+
+    // Filename without its extension. Like path::stem(), a leading dot does not start an extension.
+    std::string_view filename_stem(std::string_view name)
+    {
+        size_t dot = name.find_last_of('.');
+        return name.substr(0, dot != std::string_view::npos && dot > 0 ? dot : name.size());
+    }
+
+    std::string fold_case(std::string_view text)
+    {
+        std::string folded(text);
+        std::transform(folded.begin(), folded.end(), folded.begin(),
+                       [](unsigned char c)
+                       { return static_cast<char>(::tolower(c)); });
+        return folded;
+    }
+
+    // Add the PWADs directly inside directory to result, and collect its subdirectories if asked to
+    void scan_one_directory(const PwadScanRoot &root, const std::string &directory, const std::string &relative,
+                            PwadScanBackend backend, PwadList &result,
+                            std::vector<std::pair<std::string, std::string>> *subdirectories)
+    {
+        // Entry paths are this prefix plus the name, with the platform's separator
+        const std::string prefix = (std::filesystem::path(directory) / "").string();
+
+        // One listing pass collects the PWADs and the .txt files by case-folded stem; pairing then happens in
+        // memory instead of probing the filesystem once per PWAD
+        std::vector<std::string> pwad_names;
+        std::unordered_multimap<std::string, std::string> txt_by_stem;
+
+        auto visit = [&](std::string_view name, EntryType type)
+        {
+            if (type == EntryType::Directory)
+            {
+                if (subdirectories)
+                {
+                    std::string child_relative = relative.empty() ? std::string(name) : relative + "/" + std::string(name);
+                    if (!is_excluded(root, child_relative, name))
+                    {
+                        subdirectories->emplace_back(prefix + std::string(name), std::move(child_relative));
+                    }
+                }
+                return;
+            }
+
+            if (type != EntryType::Regular)
+            {
+                return;
+            }
+            if (has_extension(name, TXT_EXTENSIONS))
+            {
+                txt_by_stem.emplace(fold_case(filename_stem(name)), name);
+                return;
+            }
+            if (!is_pwad_file(name))
+            {
+                return;
+            }
+            if (!root.exclude.empty() &&
+                is_excluded(root, relative.empty() ? std::string(name) : relative + "/" + std::string(name), name))
+            {
+                return;
+            }
+            pwad_names.emplace_back(name);
+        };
+
+#ifdef __linux__
+        if (backend != PwadScanBackend::StdFilesystem)
+        {
+            list_directory_getdents(directory, visit);
+        }
+        else
+#endif
+        {
+            list_directory_std(directory, visit);
+        }
+
+        std::string file_path; // Reused across entries
+        std::string txt_path;
+        for (const auto &name : pwad_names)
+        {
+            file_path.assign(prefix).append(name);
+
+            // Companion text file named after the PWAD without its extension, in any letter case. An exact
+            // match wins when a folder has several, e.g. both MAP.TXT and map.txt.
+            std::string_view stem = filename_stem(name);
+            txt_path.clear();
+            auto [first, last] = txt_by_stem.equal_range(fold_case(stem));
+            for (auto it = first; it != last; ++it)
+            {
+                if (txt_path.empty() || filename_stem(it->second) == stem)
+                {
+                    txt_path.assign(prefix).append(it->second);
+                }
+            }
+
+            result.add(root.directory, file_path, txt_path);
+        }
+    }
+    // Depth-first walk of one subtree on the calling thread
+    void scan_subtree(const PwadScanRoot &root, const std::string &directory, const std::string &relative, int depth,
+                      const PwadScanOptions &options, VisitedDirectories &visited, PwadList &result)
+    {
+        if (options.checkpoint && !options.checkpoint())
+        {
+            return;
+        }
+        if (!visited.insert(directory))
+        {
+            return;
+        }
+
+        std::vector<std::pair<std::string, std::string>> subdirectories;
+        scan_one_directory(root, directory, relative, options.backend, result,
+                           depth < root.max_depth ? &subdirectories : nullptr);
+        for (const auto &[path, child_relative] : subdirectories)
+        {
+            scan_subtree(root, path, child_relative, depth + 1, options, visited, result);
+        }
+    }
+
+    void scan_recursive_root(const PwadScanRoot &root, const PwadScanOptions &options, VisitedDirectories &visited,
+                             PwadList &result)
+    {
+        if (!visited.insert(root.directory))
+        {
+            return;
+        }
+
+        std::vector<std::pair<std::string, std::string>> subdirectories;
+        scan_one_directory(root, root.directory, "", options.backend, result, root.max_depth > 0 ? &subdirectories : nullptr);
+        if (subdirectories.empty())
+        {
+            return;
+        }
+
+        // Each top-level subdirectory is one task; workers pull the next one until none are left
+        std::vector<PwadList> partial(subdirectories.size());
+        std::atomic<size_t> next(0);
+        auto worker = [&]()
+        {
+            for (size_t i = next++; i < subdirectories.size(); i = next++)
+            {
+                scan_subtree(root, subdirectories[i].first, subdirectories[i].second, 1, options, visited, partial[i]);
+            }
+        };
+
+        size_t max_threads = options.max_threads > 0 ? options.max_threads : std::max(1u, std::thread::hardware_concurrency());
+        size_t thread_count = std::min(max_threads, subdirectories.size());
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < thread_count; i++)
+        {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        for (const auto &list : partial)
+        {
+            result.append(list);
+        }
+    }
+
+    // Listing only gives names and types; sizes and times come from one batch with many stats in flight
+    void collect_metadata(PwadList &result, size_t max_in_flight, BatchStatBackend backend)
+    {
+        std::vector<std::string> paths;
+        paths.reserve(result.size());
+        for (size_t i = 0; i < result.size(); i++)
+        {
+            paths.emplace_back(result.filepath(i));
+        }
+        std::vector<FileMetadata> metadata = batch_stat(paths, max_in_flight, backend);
+        for (size_t i = 0; i < metadata.size(); i++)
+        {
+            if (metadata[i].ok)
+            {
+                result.set_metadata(i, metadata[i].size, metadata[i].mtime);
+            }
+        }
+    }
+}
+
+bool is_pwad_file(std::string_view filename)
+{
+    return has_extension(filename, WAD_EXTENSIONS) ||
+           has_extension(filename, DEH_EXTENSIONS) ||
+           has_extension(filename, EDF_EXTENSIONS);
+}
+
+bool glob_match(std::string_view pattern, std::string_view text)
+{
+    // Greedy matching with a single backtrack point for the most recent '*'
+    size_t p = 0;
+    size_t t = 0;
+    size_t star = std::string_view::npos;
+    size_t star_text = 0;
+    while (t < text.size())
+    {
+        if (p < pattern.size() && pattern[p] == '*')
+        {
+            star = p++;
+            star_text = t;
+        }
+        else if (p < pattern.size() &&
+                 (pattern[p] == '?' || ::tolower(static_cast<unsigned char>(pattern[p])) ==
+                                           ::tolower(static_cast<unsigned char>(text[t]))))
+        {
+            p++;
+            t++;
+        }
+        else if (star != std::string_view::npos)
+        {
+            p = star + 1;
+            t = ++star_text;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*')
+    {
+        p++;
+    }
+    return p == pattern.size();
+}
+
+std::vector<PwadList> scan_pwad_root_listings(const std::vector<PwadScanRoot> &roots, const PwadScanOptions &options,
+                                              std::vector<PwadRootScanStats> *stats)
+{
+    std::vector<PwadList> listings(roots.size());
+    VisitedDirectories visited;
+    if (stats)
+    {
+        stats->assign(roots.size(), PwadRootScanStats());
+    }
+
+    // Once any scanning thread's checkpoint says stop, the others stop at their next directory too
+    std::atomic<bool> abandoned(false);
+    PwadScanOptions scan_options = options;
+    if (options.checkpoint)
+    {
+        scan_options.checkpoint = [&]()
+        {
+            if (!abandoned && !options.checkpoint())
+            {
+                abandoned = true;
+            }
+            return !abandoned;
+        };
+    }
+
+    for (size_t r = 0; r < roots.size(); r++)
+    {
+        const PwadScanRoot &root = roots[r];
+        if (scan_options.checkpoint && !scan_options.checkpoint())
+        {
+            break;
+        }
+        auto started = std::chrono::steady_clock::now();
+        PwadList &result = listings[r];
+
+        std::error_code ec;
+        if (!std::filesystem::is_directory(root.directory, ec))
+        {
+            continue;
+        }
+
+        if (stats)
+        {
+            (*stats)[r].found = true;
+        }
+        if (root.recursive)
+        {
+            scan_recursive_root(root, scan_options, visited, result);
+        }
+        else if (visited.insert(root.directory))
+        {
+            scan_one_directory(root, root.directory, "", options.backend, result, nullptr);
+        }
+
+        if (abandoned)
+        {
+            // A root cut short is not reported as found, so nobody mistakes its partial listing for the whole
+            if (stats)
+            {
+                (*stats)[r].found = false;
+            }
+            break;
+        }
+
+        if (options.collect_metadata && !result.empty())
+        {
+            collect_metadata(result, options.max_metadata_requests, options.metadata_backend);
+        }
+        result.shrink_to_fit();
+
+        if (stats)
+        {
+            (*stats)[r].files = result.size();
+            (*stats)[r].milliseconds =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        }
+    }
+
+    return listings;
+}
+
+PwadList scan_pwad_roots(const std::vector<PwadScanRoot> &roots, const PwadScanOptions &options,
+                         std::vector<PwadRootScanStats> *stats)
+{
+    PwadList result;
+    for (const auto &listing : scan_pwad_root_listings(roots, options, stats))
+    {
+        result.append(listing);
+    }
+    result.shrink_to_fit();
+    return result;
+}
+
+std::vector<PwadScanRoot> get_pwad_scan_roots(const nlohmann::json &config)
+{
+    std::vector<PwadScanRoot> roots;
+    if (!config.contains("pwad_directories") || !config["pwad_directories"].is_array())
+    {
+        return roots;
+    }
+
+    const nlohmann::json *options = nullptr;
+    if (config.contains("pwad_directory_options") && config["pwad_directory_options"].is_object())
+    {
+        options = &config["pwad_directory_options"];
+    }
+
+    for (const auto &directory : config["pwad_directories"])
+    {
+        if (!directory.is_string())
+        {
+            continue;
+        }
+        PwadScanRoot root;
+        root.directory = directory.get<std::string>();
+        if (options && options->contains(root.directory) && (*options)[root.directory].is_object())
+        {
+            const nlohmann::json &option = (*options)[root.directory];
+            // Hand-edited values of the wrong type keep the defaults rather than failing the whole scan
+            if (option.contains("recursive") && option["recursive"].is_boolean())
+            {
+                root.recursive = option["recursive"].get<bool>();
+            }
+            if (option.contains("max_depth") && option["max_depth"].is_number_integer())
+            {
+                root.max_depth = std::max(0, option["max_depth"].get<int>());
+            }
+            if (option.contains("exclude") && option["exclude"].is_array())
+            {
+                for (const auto &pattern : option["exclude"])
+                {
+                    if (pattern.is_string() && !pattern.get_ref<const std::string &>().empty())
+                    {
+                        root.exclude.push_back(pattern.get<std::string>());
+                    }
+                }
+            }
+        }
+        roots.push_back(std::move(root));
+    }
+    return roots;
+}
+
+PwadList scan_pwad_directories(const std::vector<std::string> &directories, const PwadScanOptions &options)
+{
+    std::vector<PwadScanRoot> roots;
+    for (const auto &directory : directories)
+    {
+        PwadScanRoot root;
+        root.directory = directory;
+        roots.push_back(std::move(root));
+    }
+    return scan_pwad_roots(roots, options);
+}
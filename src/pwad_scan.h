@@ -0,0 +1,71 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+#include "batch_stat.h"
+#include "launch_utils.h"
+#include "pwad_list.h"
+
+// One registered PWAD directory and how deep to look inside it
+struct PwadScanRoot
+{
+    std::string directory;
+    bool recursive = false;
+    int max_depth = 8;                // Subdirectory levels below the root, when recursive
+    std::vector<std::string> exclude; // Globs matched against the path relative to the root, or the bare name
+};
+
+// How directories are listed. Auto uses getdents64 on Linux and std::filesystem elsewhere.
+enum class PwadScanBackend
+{
+    Auto,
+    StdFilesystem,
+    Getdents // Linux only; same as StdFilesystem on other platforms
+};
+
+struct PwadScanOptions
+{
+    PwadScanBackend backend = PwadScanBackend::Auto;
+    bool collect_metadata = false;      // Fill in each file's size and modification time
+    size_t max_metadata_requests = 256; // Metadata requests kept in flight at once
+    BatchStatBackend metadata_backend = BatchStatBackend::ThreadPool;
+    size_t max_threads = 0;             // Threads listing a recursive root's subtrees; 0 means one per core
+    // Called by every scanning thread before each directory, e.g. to throttle. Returning false abandons the scan;
+    // the roots finished so far are still returned.
+    std::function<bool()> checkpoint;
+};
+
+// What scanning one root took, for the settings view
+struct PwadRootScanStats
+{
+    bool found = false; // The root was a readable directory and its scan was not abandoned
+    size_t files = 0;
+    double milliseconds = 0.0;
+};
+
+// True for files the launcher lists as PWADs (WAD, DEH or EDF extensions)
+bool is_pwad_file(std::string_view filename);
+
+// Case-insensitive glob match: '*' matches any run of characters including '/', '?' matches one character
+bool glob_match(std::string_view pattern, std::string_view text);
+
+// List the PWADs under each root, pairing them with companion .txt files. Files found in subdirectories are
+// recorded under their registered root, so the UI groups them by it. Each physical directory is visited once,
+// which stops symlink loops. Subtrees of a recursive root are scanned concurrently. Selection flags are left false.
+// Touches no global state, so it can run on a background thread.
+// Returns one list per root, in order; a root that was not found gets an empty list.
+// If stats is given it receives one entry per root, in order.
+std::vector<PwadList> scan_pwad_root_listings(const std::vector<PwadScanRoot> &roots,
+                                              const PwadScanOptions &options = {},
+                                              std::vector<PwadRootScanStats> *stats = nullptr);
+
+// scan_pwad_root_listings() with every root's files in one list
+PwadList scan_pwad_roots(const std::vector<PwadScanRoot> &roots, const PwadScanOptions &options = {},
+                         std::vector<PwadRootScanStats> *stats = nullptr);
+
+// The roots for config["pwad_directories"], with per-directory settings from config["pwad_directory_options"]:
+//   {"<directory>": {"recursive": true, "max_depth": 8, "exclude": ["backup", "*.bak"]}}
+std::vector<PwadScanRoot> get_pwad_scan_roots(const nlohmann::json &config);
+
+// scan_pwad_roots() with every directory scanned non-recursively
+PwadList scan_pwad_directories(const std::vector<std::string> &directories, const PwadScanOptions &options = {});
@@ -0,0 +1,74 @@
+#include "pwad_snapshot.h"
+#include <cstring>
+
+namespace
+{
+    bool same_files(const PwadList &a, const PwadList &b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            if (strcmp(a.filepath(i), b.filepath(i)) != 0 || strcmp(a.txt_filepath(i), b.txt_filepath(i)) != 0 ||
+                a.has_metadata(i) != b.has_metadata(i) || a.file_size(i) != b.file_size(i) ||
+                a.modified_time(i) != b.modified_time(i))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+PwadSnapshot::PwadSnapshot(uint64_t version, std::vector<std::shared_ptr<const PwadRootListing>> listings,
+                           std::vector<PwadRootStatus> roots, bool served_from_index)
+    : version_(version), listings_(std::move(listings)), roots_(std::move(roots)),
+      served_from_index_(served_from_index)
+{
+    for (const auto &listing : listings_)
+    {
+        first_records_.push_back(size_);
+        size_ += listing->files.size();
+    }
+}
+
+bool PwadSnapshot::same_files_as(const PwadSnapshot &other) const
+{
+    return listings_ == other.listings_;
+}
+
+PwadSnapshotPtr make_pwad_snapshot(const PwadSnapshot *base, PwadIndexedScan scan)
+{
+    std::vector<std::shared_ptr<const PwadRootListing>> listings;
+    for (size_t r = 0; r < scan.listings.size() && r < scan.roots.size(); r++)
+    {
+        PwadList &files = scan.listings[r];
+        if (files.empty())
+        {
+            continue;
+        }
+        const std::string &directory = scan.roots[r].directory;
+        std::shared_ptr<const PwadRootListing> reused;
+        if (base)
+        {
+            for (const auto &previous : base->listings())
+            {
+                if (previous->directory == directory && same_files(previous->files, files))
+                {
+                    reused = previous;
+                    break;
+                }
+            }
+        }
+        if (!reused)
+        {
+            reused = std::make_shared<const PwadRootListing>(PwadRootListing{directory, std::move(files)});
+        }
+        listings.push_back(std::move(reused));
+    }
+
+    return std::make_shared<const PwadSnapshot>(base ? base->version() + 1 : 1, std::move(listings),
+                                                std::move(scan.roots), scan.served_from_index);
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "pwad_index.h"
+#include "pwad_list.h"
+
+// The files of one registered root as of one scan. Shared by every snapshot until that root's files change.
+struct PwadRootListing
+{
+    std::string directory;
+    PwadList files;
+};
+
+// Immutable view of the whole PWAD model. Workers build the next snapshot while the UI keeps drawing the one it
+// holds; neither ever waits on the other.
+class PwadSnapshot
+{
+public:
+    PwadSnapshot() = default;
+    PwadSnapshot(uint64_t version, std::vector<std::shared_ptr<const PwadRootListing>> listings,
+                 std::vector<PwadRootStatus> roots, bool served_from_index);
+
+    // Bumped for every snapshot built on top of another
+    uint64_t version() const { return version_; }
+    // One listing per root that has files, in root order. Selection flags are left false; the UI keeps its own.
+    const std::vector<std::shared_ptr<const PwadRootListing>> &listings() const { return listings_; }
+    // Files across every listing. They are numbered through the listings in order, which is how the UI keys its
+    // per-file state.
+    size_t size() const { return size_; }
+    size_t record(size_t listing, size_t index) const { return first_records_[listing] + index; }
+    const std::vector<PwadRootStatus> &roots() const { return roots_; }
+    bool served_from_index() const { return served_from_index_; }
+
+    // True if both snapshots hold the very same listings, i.e. no root's files changed in between
+    bool same_files_as(const PwadSnapshot &other) const;
+
+private:
+    uint64_t version_ = 0;
+    std::vector<std::shared_ptr<const PwadRootListing>> listings_;
+    std::vector<size_t> first_records_; // Per listing
+    size_t size_ = 0;
+    std::vector<PwadRootStatus> roots_;
+    bool served_from_index_ = false;
+};
+
+using PwadSnapshotPtr = std::shared_ptr<const PwadSnapshot>;
+
+// The snapshot that follows base after a scan. Roots whose files are unchanged keep base's listing and drop the
+// scanned one; the others take over the scan's list. base may be null.
+PwadSnapshotPtr make_pwad_snapshot(const PwadSnapshot *base, PwadIndexedScan scan);
+
+// Where the latest snapshot is published. Loads and stores swap the pointer atomically, so a reader always gets
+// a whole snapshot and keeps it alive for as long as it holds the pointer.
+class PwadSnapshotSlot
+{
+public:
+    PwadSnapshotPtr load() const { return std::atomic_load(&current_); }
+    void publish(PwadSnapshotPtr snapshot) { std::atomic_store(&current_, std::move(snapshot)); }
+
+private:
+    PwadSnapshotPtr current_;
+};
@@ -0,0 +1,206 @@
+#include "task_scheduler.h"
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+    // Which scheduler and worker the calling thread belongs to, so tasks submitted from a task stay local
+    thread_local const TaskScheduler *current_scheduler = nullptr;
+    thread_local size_t current_worker = 0;
+}
+
+TaskScheduler::TaskScheduler(size_t worker_count)
+{
+    if (worker_count == 0)
+    {
+        worker_count = std::max<size_t>(2, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < worker_count; i++)
+    {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    // Start the threads only once every worker exists, since they steal from each other
+    for (size_t i = 0; i < worker_count; i++)
+    {
+        workers_[i]->thread = std::thread(&TaskScheduler::worker_loop, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    shutdown();
+}
+
+void TaskScheduler::shutdown()
+{
+    std::vector<Task> dropped; // Destroyed after the locks are released, in case a task's captures do real work
+    {
+        std::lock_guard<std::mutex> state_lock(state_mutex_);
+        stopping_ = true;
+        for (auto &worker : workers_)
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            for (auto &queue : worker->queues)
+            {
+                std::move(queue.begin(), queue.end(), std::back_inserter(dropped));
+                queue.clear();
+            }
+        }
+        queued_ -= dropped.size();
+        outstanding_ -= dropped.size();
+        if (outstanding_ == 0)
+        {
+            idle_.notify_all();
+        }
+    }
+    wake_.notify_all();
+    for (auto &worker : workers_)
+    {
+        if (worker->thread.joinable())
+        {
+            worker->thread.join();
+        }
+    }
+}
+
+void TaskScheduler::submit(std::function<void()> task, TaskPriority priority, CancellationToken token)
+{
+    size_t index = current_scheduler == this ? current_worker : next_worker_++ % workers_.size();
+    {
+        // Counted before it is published, since a worker can take and finish the task as soon as it is queued.
+        // Holding state_mutex_ across the push also keeps woken workers from finding queued_ ahead of the deque.
+        std::lock_guard<std::mutex> state_lock(state_mutex_);
+        if (stopping_)
+        {
+            return; // Nothing would ever run it
+        }
+        queued_++;
+        outstanding_++;
+        std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+        workers_[index]->queues[static_cast<int>(priority)].push_back(Task{std::move(task), std::move(token)});
+    }
+    wake_.notify_one();
+}
+
+bool TaskScheduler::take_task(size_t index, Task &task)
+{
+    // Interactive work anywhere in the pool goes before background work
+    for (int priority = 0; priority < 2; priority++)
+    {
+        {
+            Worker &own = *workers_[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            auto &queue = own.queues[priority];
+            if (!queue.empty())
+            {
+                task = std::move(queue.back());
+                queue.pop_back();
+                queued_--;
+                return true;
+            }
+        }
+        for (size_t offset = 1; offset < workers_.size(); offset++)
+        {
+            Worker &victim = *workers_[(index + offset) % workers_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            auto &queue = victim.queues[priority];
+            if (!queue.empty())
+            {
+                task = std::move(queue.front());
+                queue.pop_front();
+                queued_--;
+                stolen_++;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::worker_loop(size_t index)
+{
+    current_scheduler = this;
+    current_worker = index;
+
+    while (true)
+    {
+        Task task;
+        if (!take_task(index, task))
+        {
+            std::unique_lock<std::mutex> lock(state_mutex_);
+            wake_.wait(lock, [this]
+                       { return stopping_ || queued_ > 0; });
+            if (stopping_)
+            {
+                return;
+            }
+            continue;
+        }
+
+        if (task.token.cancelled())
+        {
+            cancelled_++;
+        }
+        else
+        {
+            try
+            {
+                task.fn();
+            }
+            catch (...)
+            {
+                // A failing task must not take its worker down with it; tasks report errors through their results
+            }
+            executed_++;
+        }
+        task = Task();
+
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        if (--outstanding_ == 0)
+        {
+            idle_.notify_all();
+        }
+    }
+}
+
+void TaskScheduler::post_to_main_thread(std::function<void()> fn)
+{
+    std::lock_guard<std::mutex> lock(main_mutex_);
+    main_queue_.push_back(std::move(fn));
+}
+
+size_t TaskScheduler::drain_main_thread_queue()
+{
+    {
+        std::lock_guard<std::mutex> lock(main_mutex_);
+        if (main_queue_.empty())
+        {
+            return 0;
+        }
+        main_running_.swap(main_queue_);
+    }
+    // Callbacks may post more; those run on the next drain
+    for (auto &fn : main_running_)
+    {
+        fn();
+    }
+    size_t count = main_running_.size();
+    main_running_.clear();
+    return count;
+}
+
+void TaskScheduler::wait_idle()
+{
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    idle_.wait(lock, [this]
+               { return outstanding_ == 0; });
+}
+
+TaskScheduler::Stats TaskScheduler::stats() const
+{
+    Stats stats;
+    stats.executed = executed_;
+    stats.stolen = stolen_;
+    stats.cancelled = cancelled_;
+    return stats;
+}
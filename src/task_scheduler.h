@@ -0,0 +1,108 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+enum class TaskPriority
+{
+    Interactive, // Something on screen is waiting for it; runs before any queued background task
+    Background
+};
+
+// Shared flag for abandoning work. Copies share the flag. A task whose token is cancelled before it starts is
+// dropped; a running task can poll cancelled() to stop early.
+class CancellationToken
+{
+public:
+    CancellationToken() : cancelled_(std::make_shared<std::atomic<bool>>(false)) {}
+    void cancel() { *cancelled_ = true; }
+    bool cancelled() const { return *cancelled_; }
+
+private:
+    std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+// Fixed pool of workers, each with its own deques (one per priority). A worker pops its newest task and, when it
+// runs dry, steals the oldest task from another worker, so tasks that spawn tasks stay on one thread until others
+// are idle. Results go back to the UI thread through post_to_main_thread(), drained once per frame.
+class TaskScheduler
+{
+public:
+    struct Stats
+    {
+        uint64_t executed = 0;
+        uint64_t stolen = 0;    // Executed by a worker other than the one it was queued on
+        uint64_t cancelled = 0; // Dropped because their token was cancelled before they started
+    };
+
+    // worker_count 0 means one per core, but at least two, so a background task blocked on a slow share or a
+    // paused checkpoint cannot hold up interactive work
+    explicit TaskScheduler(size_t worker_count = 0);
+    // Calls shutdown()
+    ~TaskScheduler();
+    TaskScheduler(const TaskScheduler &) = delete;
+    TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+    // Queue a task. From a worker it goes on that worker's own deque; from elsewhere the workers take turns.
+    // Ignored after shutdown().
+    void submit(std::function<void()> task, TaskPriority priority = TaskPriority::Background,
+                CancellationToken token = CancellationToken());
+
+    // Queue fn to run on the main thread in the next drain_main_thread_queue(); callable from any thread
+    void post_to_main_thread(std::function<void()> fn);
+    // Run everything posted so far on the calling (main) thread and return how many ran. Allocation free when
+    // nothing is queued.
+    size_t drain_main_thread_queue();
+
+    // Block until every submitted task has run or been dropped. Not for use from inside a task.
+    void wait_idle();
+    // Drop queued tasks and wait for the running ones. The scheduler stays valid, so running tasks can still
+    // post_to_main_thread(), and later submits are ignored rather than queued.
+    void shutdown();
+
+    size_t worker_count() const { return workers_.size(); }
+    Stats stats() const;
+
+private:
+    struct Task
+    {
+        std::function<void()> fn;
+        CancellationToken token;
+    };
+
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Task> queues[2]; // Indexed by TaskPriority
+        std::thread thread;
+    };
+
+    void worker_loop(size_t index);
+    bool take_task(size_t index, Task &task);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> next_worker_{0}; // Round robin for submits from outside the pool
+
+    // Guards stopping_ and outstanding_, and pairs with the condition variables. Taken before a worker's mutex when
+    // both are held.
+    std::mutex state_mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::atomic<size_t> queued_{0};
+    size_t outstanding_ = 0; // Queued plus running
+    bool stopping_ = false;
+
+    std::mutex main_mutex_;
+    std::vector<std::function<void()>> main_queue_;
+    std::vector<std::function<void()>> main_running_; // Swapped with main_queue_ to run without the lock
+
+    std::atomic<uint64_t> executed_{0};
+    std::atomic<uint64_t> stolen_{0};
+    std::atomic<uint64_t> cancelled_{0};
+};
@@ -0,0 +1,196 @@
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+namespace
+{
+    // Per thread; the oldest spans are overwritten once a thread records more than this
+    const size_t TRACE_BUFFER_EVENTS = 4096;
+
+    struct TraceEvent
+    {
+        const char *name;
+        int tid;
+        int64_t begin_us;
+        int64_t duration_us;
+    };
+
+    struct ThreadTraceBuffer
+    {
+        TraceEvent events[TRACE_BUFFER_EVENTS];
+        std::atomic<uint64_t> written{0};
+        std::atomic<bool> in_use{true};
+    };
+
+    std::atomic<bool> tracing{false};
+    std::chrono::steady_clock::time_point trace_start;
+    std::string trace_path;
+    std::atomic<int> next_tid{1};
+
+    // Only taken when a thread records its first span, when naming a thread, and by stop_trace()
+    std::mutex registry_mutex;
+    std::vector<std::unique_ptr<ThreadTraceBuffer>> buffers;
+    std::map<int, const char *> thread_names;
+
+    // Hands the buffer back for reuse when its thread exits, so short-lived workers do not grow the registry.
+    // The events stay in place and keep their original tid.
+    struct ThreadTraceState
+    {
+        int tid = next_tid.fetch_add(1);
+        ThreadTraceBuffer *buffer = nullptr;
+
+        ~ThreadTraceState()
+        {
+            if (buffer)
+            {
+                buffer->in_use.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    thread_local ThreadTraceState thread_state;
+
+    ThreadTraceBuffer *get_thread_buffer()
+    {
+        if (thread_state.buffer)
+        {
+            return thread_state.buffer;
+        }
+
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        for (auto &buffer : buffers)
+        {
+            bool expected = false;
+            if (buffer->in_use.compare_exchange_strong(expected, true))
+            {
+                thread_state.buffer = buffer.get();
+                return thread_state.buffer;
+            }
+        }
+        buffers.push_back(std::make_unique<ThreadTraceBuffer>());
+        thread_state.buffer = buffers.back().get();
+        return thread_state.buffer;
+    }
+
+    int64_t microseconds_since_start(std::chrono::steady_clock::time_point time)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(time - trace_start).count();
+    }
+}
+
+bool start_trace(const std::string &path)
+{
+    std::ofstream probe(path);
+    if (!probe.is_open())
+    {
+        return false;
+    }
+
+    // Nothing records while tracing is off, so the previous session's spans can be dropped safely
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        for (auto &buffer : buffers)
+        {
+            buffer->written.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    trace_path = path;
+    trace_start = std::chrono::steady_clock::now();
+    tracing.store(true, std::memory_order_release);
+    return true;
+}
+
+bool stop_trace()
+{
+    if (!tracing.exchange(false))
+    {
+        return false;
+    }
+
+    nlohmann::json events = nlohmann::json::array();
+    events.push_back({{"name", "process_name"}, {"ph", "M"}, {"pid", 1}, {"tid", 0}, {"args", {{"name", "just_launch_doom"}}}});
+
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        for (const auto &entry : thread_names)
+        {
+            events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", entry.first}, {"args", {{"name", entry.second}}}});
+        }
+
+        // Worker threads that are still running may keep writing; only the slots they overwrite are affected
+        for (const auto &buffer : buffers)
+        {
+            uint64_t written = buffer->written.load(std::memory_order_acquire);
+            uint64_t count = std::min<uint64_t>(written, TRACE_BUFFER_EVENTS);
+            for (uint64_t i = written - count; i < written; i++)
+            {
+                const TraceEvent &event = buffer->events[i % TRACE_BUFFER_EVENTS];
+                events.push_back({{"name", event.name},
+                                  {"cat", "launcher"},
+                                  {"ph", "X"},
+                                  {"pid", 1},
+                                  {"tid", event.tid},
+                                  {"ts", event.begin_us},
+                                  {"dur", event.duration_us}});
+            }
+        }
+    }
+
+    std::ofstream file(trace_path);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    file << nlohmann::json{{"traceEvents", events}, {"displayTimeUnit", "ms"}}.dump();
+    return file.good();
+}
+
+bool is_tracing()
+{
+    return tracing.load(std::memory_order_relaxed);
+}
+
+void set_trace_thread_name(const char *name)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    thread_names[thread_state.tid] = name;
+}
+
+void record_trace_span(const char *name, std::chrono::steady_clock::time_point begin,
+                       std::chrono::steady_clock::time_point end)
+{
+    if (!tracing.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    ThreadTraceBuffer *buffer = get_thread_buffer();
+    uint64_t index = buffer->written.load(std::memory_order_relaxed);
+    buffer->events[index % TRACE_BUFFER_EVENTS] = {name, thread_state.tid, microseconds_since_start(begin),
+                                                   std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()};
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+TraceScope::TraceScope(const char *name) : name(name), active(tracing.load(std::memory_order_relaxed))
+{
+    if (active)
+    {
+        begin = std::chrono::steady_clock::now();
+    }
+}
+
+TraceScope::~TraceScope()
+{
+    if (active)
+    {
+        record_trace_span(name, begin, std::chrono::steady_clock::now());
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <chrono>
+#include <string>
+
+// Spans in the Trace Event Format, loadable in about://tracing and Perfetto.
+// Each thread records into its own ring buffer without locking; the file is only written by stop_trace().
+// While tracing is off a span costs one relaxed atomic load.
+
+bool start_trace(const std::string &path);
+
+// Write the recorded spans to the path given to start_trace(). Safe to call when not tracing.
+bool stop_trace();
+
+bool is_tracing();
+
+// Label the calling thread in the trace viewer. name must outlive the trace (a string literal).
+void set_trace_thread_name(const char *name);
+
+// Record a span measured elsewhere. name must be a string literal, since only the pointer is stored.
+void record_trace_span(const char *name, std::chrono::steady_clock::time_point begin,
+                       std::chrono::steady_clock::time_point end);
+
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name);
+    ~TraceScope();
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *name;
+    bool active;
+    std::chrono::steady_clock::time_point begin;
+};
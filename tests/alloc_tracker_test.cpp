@@ -0,0 +1,97 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "../src/alloc_tracker.h"
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Built with JUST_LAUNCH_DOOM_TRACK_ALLOCATIONS, see the Makefile test target
+
+static AllocationCounts find_scope(const char *name)
+{
+    for (const auto &scope : get_last_frame_scope_allocations())
+    {
+        if (scope.name == name)
+        {
+            return scope.counts;
+        }
+    }
+    return {};
+}
+
+TEST_CASE("operator new is counted")
+{
+    REQUIRE(allocation_tracking_available());
+
+    AllocationCounts before = get_total_allocations();
+    auto value = std::make_unique<int>(42);
+    auto buffer = std::make_unique<char[]>(1000);
+    AllocationCounts after = get_total_allocations();
+
+    CHECK(after.allocations - before.allocations == 2);
+    CHECK(after.bytes - before.bytes >= sizeof(int) + 1000);
+}
+
+TEST_CASE("a frame with no allocations counts zero")
+{
+    begin_allocation_frame();
+    int total = 0;
+    for (int i = 0; i < 100; i++)
+    {
+        total += i;
+    }
+    end_allocation_frame();
+
+    CHECK(total == 4950);
+    CHECK(get_last_frame_allocations().allocations == 0);
+    CHECK(get_last_frame_scope_allocations().empty());
+}
+
+TEST_CASE("allocations are charged to the innermost scope")
+{
+    static const char outer_name[] = "outer";
+    static const char inner_name[] = "inner";
+
+    std::vector<std::unique_ptr<int>> keep;
+    keep.reserve(8);
+
+    begin_allocation_frame();
+    {
+        AllocationScope outer(outer_name);
+        keep.push_back(std::make_unique<int>(1));
+        {
+            AllocationScope inner(inner_name);
+            keep.push_back(std::make_unique<int>(2));
+            keep.push_back(std::make_unique<int>(3));
+        }
+        keep.push_back(std::make_unique<int>(4));
+    }
+    keep.push_back(std::make_unique<int>(5)); // Outside any scope: totals only
+    end_allocation_frame();
+
+    CHECK(find_scope(outer_name).allocations == 2);
+    CHECK(find_scope(inner_name).allocations == 2);
+    CHECK(get_last_frame_allocations().allocations == 5);
+
+    // Scopes are reset at the next frame boundary
+    begin_allocation_frame();
+    end_allocation_frame();
+    CHECK(find_scope(outer_name).allocations == 0);
+}
+
+TEST_CASE("scopes are per thread")
+{
+    static const char worker_name[] = "worker";
+
+    begin_allocation_frame();
+    std::thread worker([]
+                       {
+                           AllocationScope scope(worker_name);
+                           std::string text(100, 'x');
+                           CHECK(text.size() == 100); });
+    worker.join();
+    end_allocation_frame();
+
+    CHECK(find_scope(worker_name).allocations >= 1);
+}
@@ -0,0 +1,104 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "../src/background_io.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// The idle I/O class is always set; the CPU side is skipped where it could not be undone
+static bool thread_is_lowered()
+{
+    return (syscall(SYS_ioprio_get, 1, 0) >> 13) == 3;
+}
+#endif
+
+static bool wait_for(const std::atomic<bool> &flag)
+{
+    for (int i = 0; i < 500 && !flag; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return flag;
+}
+
+TEST_CASE("checkpoints lower and restore a worker's priority")
+{
+    set_background_io_mode(BackgroundIoMode::Normal);
+    std::atomic<bool> lowered(false);
+    std::atomic<bool> restored(false);
+    std::atomic<bool> lower(false);
+    std::atomic<bool> restore(false);
+
+    std::thread worker([&]
+                       {
+                           BackgroundJob job("test job");
+                           while (!lower) std::this_thread::yield();
+                           background_io_checkpoint();
+#ifdef __linux__
+                           lowered = thread_is_lowered();
+#else
+                           lowered = true;
+#endif
+                           while (!restore) std::this_thread::yield();
+                           background_io_checkpoint();
+#ifdef __linux__
+                           pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+                           restored = !thread_is_lowered() && sched_getscheduler(0) == SCHED_OTHER &&
+                                      getpriority(PRIO_PROCESS, tid) == 0;
+#else
+                           restored = true;
+#endif
+                       });
+
+    set_background_io_mode(BackgroundIoMode::LowPriority);
+    lower = true;
+    CHECK(wait_for(lowered));
+
+    auto jobs = get_background_jobs();
+    REQUIRE(jobs.size() == 1);
+    CHECK(jobs[0].name == "test job");
+    CHECK(jobs[0].mode == BackgroundIoMode::LowPriority);
+
+    // The thread that sets the mode is the UI thread; its own checkpoints change nothing
+    background_io_checkpoint();
+#ifdef __linux__
+    CHECK_FALSE(thread_is_lowered());
+#endif
+
+    set_background_io_mode(BackgroundIoMode::Normal);
+    restore = true;
+    worker.join();
+    CHECK(restored);
+    CHECK(get_background_jobs().empty());
+}
+
+TEST_CASE("suspended workers wait at their checkpoint until resumed")
+{
+    set_background_io_mode(BackgroundIoMode::Suspended);
+    std::atomic<bool> passed(false);
+    std::thread worker([&]
+                       {
+                           BackgroundJob job("suspended job");
+                           background_io_checkpoint();
+                           passed = true; });
+
+    std::atomic<bool> waiting(false);
+    for (int i = 0; i < 500 && !waiting; i++)
+    {
+        auto jobs = get_background_jobs();
+        waiting = !jobs.empty() && jobs[0].waiting;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    CHECK(waiting);
+    CHECK_FALSE(passed);
+
+    set_background_io_mode(BackgroundIoMode::Normal);
+    worker.join();
+    CHECK(passed);
+}
@@ -0,0 +1,70 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "../src/batch_stat.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+namespace fs = std::filesystem;
+
+static const std::string test_root = (fs::temp_directory_path() / "just_launch_doom_batch_stat_test").string();
+
+static std::vector<std::string> make_files(size_t count)
+{
+    fs::remove_all(test_root);
+    fs::create_directories(test_root);
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < count; i++)
+    {
+        std::string path = test_root + "/file" + std::to_string(i) + ".wad";
+        std::ofstream(path) << std::string(i * 7, 'x');
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+static void check_against_stat(const std::vector<std::string> &paths, const std::vector<FileMetadata> &results)
+{
+    REQUIRE(results.size() == paths.size());
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        struct stat st;
+        if (stat(paths[i].c_str(), &st) != 0)
+        {
+            CHECK_FALSE(results[i].ok);
+            continue;
+        }
+        CHECK(results[i].ok);
+        CHECK(results[i].size == static_cast<uint64_t>(st.st_size));
+        CHECK(results[i].mtime == static_cast<int64_t>(st.st_mtime));
+    }
+}
+
+TEST_CASE("batch_stat matches stat() with every backend")
+{
+    std::vector<std::string> paths = make_files(300);
+    paths.insert(paths.begin() + 10, test_root + "/missing.wad");
+
+    for (BatchStatBackend backend : {BatchStatBackend::IoUring, BatchStatBackend::ThreadPool})
+    {
+        check_against_stat(paths, batch_stat(paths, 256, backend));
+    }
+
+    fs::remove_all(test_root);
+}
+
+TEST_CASE("batch_stat works with fewer requests in flight than paths")
+{
+    std::vector<std::string> paths = make_files(50);
+
+    for (size_t max_in_flight : {0, 1, 3, 1000})
+    {
+        check_against_stat(paths, batch_stat(paths, max_in_flight, BatchStatBackend::IoUring));
+        check_against_stat(paths, batch_stat(paths, max_in_flight, BatchStatBackend::ThreadPool));
+    }
+    CHECK(batch_stat({}).empty());
+
+    fs::remove_all(test_root);
+}
@@ -0,0 +1,69 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "../src/cli.h"
+#include <string>
+#include <vector>
+
+static CliOptions parse(std::vector<std::string> args)
+{
+    args.insert(args.begin(), "just_launch_doom");
+    std::vector<char *> argv;
+    for (auto &arg : args)
+    {
+        argv.push_back(arg.data());
+    }
+    return parse_cli_args(static_cast<int>(argv.size()), argv.data());
+}
+
+TEST_CASE("No arguments opens the launcher window")
+{
+    CliOptions options = parse({});
+    CHECK_FALSE(options.launch);
+    CHECK_FALSE(options.print_command);
+    CHECK(options.profile.empty());
+    CHECK_FALSE(is_headless_run(options));
+}
+
+TEST_CASE("--launch with a profile")
+{
+    CliOptions options = parse({"--launch", "--profile", "Sunlust"});
+    CHECK(options.launch);
+    CHECK(options.profile == "Sunlust");
+    CHECK(options.error.empty());
+    CHECK(is_headless_run(options));
+
+    CHECK(parse({"--profile=Eviternity II", "--launch"}).profile == "Eviternity II");
+}
+
+TEST_CASE("--print-command alone is headless")
+{
+    CliOptions options = parse({"--print-command"});
+    CHECK(options.print_command);
+    CHECK_FALSE(options.launch);
+    CHECK(is_headless_run(options));
+}
+
+TEST_CASE("--profile without a name is an error")
+{
+    CliOptions options = parse({"--launch", "--profile"});
+    CHECK_FALSE(options.error.empty());
+    CHECK(is_headless_run(options));
+}
+
+TEST_CASE("Unknown arguments are ignored in GUI mode but rejected when launching")
+{
+    CHECK_FALSE(is_headless_run(parse({"-psn_0_12345"})));
+
+    CliOptions options = parse({"--launch", "--bogus"});
+    CHECK(options.error.find("--bogus") != std::string::npos);
+}
+
+TEST_CASE("--trace takes an output path and does not force headless mode")
+{
+    CliOptions options = parse({"--trace", "startup.json"});
+    CHECK(options.trace == "startup.json");
+    CHECK_FALSE(is_headless_run(options));
+
+    CHECK(parse({"--trace=out.json", "--print-command"}).trace == "out.json");
+    CHECK_FALSE(parse({"--launch", "--trace"}).error.empty());
+}
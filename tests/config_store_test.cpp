@@ -0,0 +1,101 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "../src/config_store.h"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+static const std::string test_root = "/tmp/just_launch_doom_config_store_test";
+
+TEST_CASE("snapshots are immutable and versioned")
+{
+    ConfigStore store;
+    CHECK(store.snapshot() == nullptr);
+
+    nlohmann::json config = {{"theme", "fire"}, {"selected_pwads", {"a.wad"}}};
+    ConfigSnapshotPtr first = store.commit(config);
+    CHECK(first->version() == 1);
+    CHECK(store.snapshot() == first);
+
+    config["selected_pwads"].push_back("b.wad");
+    config["custom_params"] = "-fast";
+    CHECK(first->value("selected_pwads").size() == 1); // Editing the document leaves snapshots alone
+    CHECK_FALSE(first->contains("custom_params"));
+
+    ConfigSnapshotPtr second = store.commit(config);
+    CHECK(second->version() == 2);
+    CHECK(second->value("selected_pwads").size() == 2);
+    CHECK(second->value("custom_params") == "-fast");
+    CHECK(second->value("missing").is_null());
+    CHECK(second->document() == config);
+}
+
+TEST_CASE("commits copy only the values that changed")
+{
+    ConfigStore store;
+    nlohmann::json config = {{"theme", "fire"}, {"pwad_directories", {"/wads"}}};
+    ConfigSnapshotPtr first = store.commit(config);
+
+    CHECK(store.commit(config) == first); // Nothing changed, nothing published
+
+    config["theme"] = "dark";
+    ConfigSnapshotPtr second = store.commit(config);
+    CHECK(&second->value("pwad_directories") == &first->value("pwad_directories"));
+    CHECK(&second->value("theme") != &first->value("theme"));
+
+    config.erase("theme");
+    ConfigSnapshotPtr third = store.commit(config);
+    CHECK(third->version() == 3);
+    CHECK_FALSE(third->contains("theme"));
+}
+
+TEST_CASE("saving writes the snapshot and never rolls the file back")
+{
+    fs::remove_all(test_root);
+    std::string path = test_root + "/nested/config.json";
+    ConfigStore store;
+    nlohmann::json config = {{"theme", "fire"}};
+    ConfigSnapshotPtr older = store.commit(config);
+    config["theme"] = "dark";
+    ConfigSnapshotPtr newer = store.commit(config);
+
+    REQUIRE(store.save(path, *newer));
+    CHECK(store.save(path, *older)); // Finished late; skipped
+
+    nlohmann::json written;
+    std::ifstream(path) >> written;
+    CHECK(written["theme"] == "dark");
+    CHECK_FALSE(fs::exists(path + ".tmp"));
+
+    fs::remove_all(test_root);
+}
+
+TEST_CASE("readers on other threads see whole snapshots while the UI commits")
+{
+    ConfigStore store;
+    nlohmann::json config = {{"count", 0}, {"copy", 0}};
+    store.commit(config);
+
+    std::atomic<bool> done(false);
+    bool consistent = true;
+    std::thread reader([&]
+                       {
+                           while (!done)
+                           {
+                               ConfigSnapshotPtr snapshot = store.snapshot();
+                               consistent = consistent && snapshot->value("count") == snapshot->value("copy");
+                           } });
+    for (int i = 1; i <= 500; i++)
+    {
+        config["count"] = i;
+        config["copy"] = i;
+        store.commit(config);
+    }
+    done = true;
+    reader.join();
+    CHECK(consistent);
+    CHECK(store.snapshot()->version() == 501);
+}
@@ -0,0 +1,82 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "../src/frame_jobs.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("jobs run in order and slice by slice")
+{
+    FrameJobQueue queue;
+    std::vector<std::string> log;
+    int slices = 0;
+    queue.post([&]
+               {
+                   log.push_back("first " + std::to_string(slices));
+                   return ++slices == 3; });
+    queue.post([&]
+               {
+                   log.push_back("second");
+                   return true; });
+
+    CHECK(queue.run(1s) == 2);
+    CHECK(queue.empty());
+    CHECK(log == std::vector<std::string>{"first 0", "first 1", "first 2", "second"});
+}
+
+TEST_CASE("unfinished work carries over to the next frame")
+{
+    FrameJobQueue queue;
+    int slices = 0;
+    queue.post([&]
+               {
+                   std::this_thread::sleep_for(2ms);
+                   return ++slices == 10; });
+
+    // Each slice overruns a zero budget, so every frame gets exactly one
+    CHECK(queue.run(0us) == 0);
+    CHECK(slices == 1);
+    CHECK(queue.run(0us) == 0);
+    CHECK(slices == 2);
+
+    // A budget of a few slices finishes a few slices, not the whole job
+    queue.run(5ms);
+    CHECK(slices > 2);
+    CHECK(slices < 10);
+    CHECK(queue.size() == 1);
+
+    while (!queue.empty())
+    {
+        queue.run(5ms);
+    }
+    CHECK(slices == 10);
+}
+
+TEST_CASE("an empty queue does nothing")
+{
+    FrameJobQueue queue;
+    CHECK(queue.run(2ms) == 0);
+    CHECK(queue.empty());
+}
+
+TEST_CASE("jobs posted by a slice run after the queued ones")
+{
+    FrameJobQueue queue;
+    std::vector<int> order;
+    queue.post([&]
+               {
+                   order.push_back(1);
+                   queue.post([&]
+                              {
+                                  order.push_back(3);
+                                  return true; });
+                   return true; });
+    queue.post([&]
+               {
+                   order.push_back(2);
+                   return true; });
+    queue.run(1s);
+    CHECK(order == std::vector<int>{1, 2, 3});
+}
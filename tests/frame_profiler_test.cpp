@@ -0,0 +1,76 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "../src/frame_profiler.h"
+#include <vector>
+
+TEST_CASE("percentile uses nearest rank")
+{
+    std::vector<double> samples;
+    for (int i = 1; i <= 100; i++)
+    {
+        samples.push_back(i);
+    }
+    CHECK(percentile(samples, 50.0) == 50.0);
+    CHECK(percentile(samples, 95.0) == 95.0);
+    CHECK(percentile(samples, 99.0) == 99.0);
+    CHECK(percentile(samples, 100.0) == 100.0);
+    CHECK(percentile(samples, 0.0) == 1.0);
+    CHECK(percentile({}, 50.0) == 0.0);
+    CHECK(percentile({7.0}, 99.0) == 7.0);
+}
+
+TEST_CASE("stage times are summed per frame and ignored while disabled")
+{
+    set_frame_profiler_enabled(false);
+    begin_profiler_frame();
+    add_stage_time(FrameStage::Fire, 5.0);
+    end_profiler_frame();
+    CHECK(get_stage_stats(FrameStage::Fire).samples == 0);
+
+    set_frame_profiler_enabled(true);
+    begin_profiler_frame();
+    add_stage_time(FrameStage::LaunchCommand, 1.0);
+    add_stage_time(FrameStage::LaunchCommand, 2.0);
+    end_profiler_frame();
+
+    StageStats stats = get_stage_stats(FrameStage::LaunchCommand);
+    CHECK(stats.samples == 1);
+    CHECK(stats.last_ms == doctest::Approx(3.0));
+    CHECK(get_stage_stats(FrameStage::Fire).last_ms == 0.0);
+    set_frame_profiler_enabled(false);
+}
+
+TEST_CASE("history keeps the most recent frames oldest first")
+{
+    set_frame_profiler_enabled(true);
+    for (size_t i = 0; i < PROFILER_HISTORY_SIZE + 10; i++)
+    {
+        begin_profiler_frame();
+        add_stage_time(FrameStage::Present, static_cast<double>(i));
+        end_profiler_frame();
+    }
+
+    std::vector<float> history = get_stage_history(FrameStage::Present);
+    REQUIRE(history.size() == PROFILER_HISTORY_SIZE);
+    CHECK(history.front() == 10.0f);
+    CHECK(history.back() == static_cast<float>(PROFILER_HISTORY_SIZE + 9));
+
+    StageStats stats = get_stage_stats(FrameStage::Present);
+    CHECK(stats.max_ms == doctest::Approx(PROFILER_HISTORY_SIZE + 9));
+    CHECK(stats.last_ms == doctest::Approx(PROFILER_HISTORY_SIZE + 9));
+    set_frame_profiler_enabled(false);
+}
+
+TEST_CASE("scoped timer records into the open frame")
+{
+    set_frame_profiler_enabled(true);
+    begin_profiler_frame();
+    {
+        ScopedStageTimer timer(FrameStage::PwadList);
+    }
+    end_profiler_frame();
+    CHECK(get_stage_stats(FrameStage::PwadList).samples == 1);
+    CHECK(get_stage_stats(FrameStage::PwadList).last_ms >= 0.0);
+    CHECK(get_stage_stats(FrameStage::Frame).last_ms >= get_stage_stats(FrameStage::PwadList).last_ms);
+    set_frame_profiler_enabled(false);
+}
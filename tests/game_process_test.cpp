@@ -0,0 +1,35 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "../src/game_process.h"
+#include <chrono>
+#include <thread>
+
+static bool wait_for_exit(GameProcess &process)
+{
+    for (int i = 0; i < 1000 && process.running(); i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return !process.running();
+}
+
+#ifndef _WIN32
+TEST_CASE("GameProcess runs a command without blocking and reports its exit code")
+{
+    GameProcess process;
+    CHECK_FALSE(process.running());
+
+    REQUIRE(process.start("sleep 0.2; exit 3"));
+    CHECK(process.running());
+    CHECK_FALSE(process.start("true")); // One game at a time
+
+    REQUIRE(wait_for_exit(process));
+    CHECK(process.exit_code() == 3);
+    CHECK(process.seconds() >= 0.1);
+
+    // Shell quoting works as it did with system()
+    REQUIRE(process.start("test \"a b\" = 'a b'"));
+    REQUIRE(wait_for_exit(process));
+    CHECK(process.exit_code() == 0);
+}
+#endif
@@ -0,0 +1,98 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "../src/alloc_tracker.h"
+#include "../src/config_utils.h"
+#include "../src/nlohmann/json.hpp"
+#include <SDL.h>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// Runs the real UI from main.cpp (built with JUST_LAUNCH_DOOM_NO_MAIN and JUST_LAUNCH_DOOM_TRACK_ALLOCATIONS)
+// on SDL's dummy video driver, see the Makefile test target
+int setup();
+bool process_events();
+void render_frame();
+void clean_up();
+extern nlohmann::json config;
+
+static const int WARMUP_FRAMES = 60;
+static const int CHECKED_FRAMES = 30;
+
+// Written to the config path under the test's HOME
+static void write_idle_config(const std::string &pwad_dir)
+{
+    // Long paths so every label is past the small string buffer and would have to allocate
+    nlohmann::json config = {{"resolution", {800, 600}},
+                             {"theme", "fire"},
+                             {"pwad_directories", {pwad_dir}},
+                             {"doom_executables", {"/usr/games/a_source_port_with_a_long_name"}},
+                             {"selected_executable", "/usr/games/a_source_port_with_a_long_name"},
+                             {"iwads", {"/home/player/iwads/doom2.wad", "/home/player/other/doom2.wad"}},
+                             {"selected_iwad", "/home/player/iwads/doom2.wad"},
+                             {"config_files", {"/home/player/configs/a_long_config_file_name.ini"}},
+                             {"selected_config", "/home/player/configs/a_long_config_file_name.ini"},
+                             {"selected_pwads", {pwad_dir + "/a_selected_pwad_with_a_long_name.wad"}},
+                             {"custom_params", "-skill 4 -warp 01 +sv_cheats 1"},
+                             {"profiles", {{"UV Max", {{"selected_iwad", "/home/player/iwads/doom2.wad"}}}}},
+                             {"active_profile", "UV Max"}};
+    std::ofstream(get_config_file_path()) << config.dump(4);
+}
+
+static void run_frames(int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        process_events();
+        render_frame();
+        // Gives the background PWAD scan time to land during warmup
+        SDL_Delay(1);
+    }
+}
+
+static void check_idle_frames()
+{
+    for (int i = 0; i < CHECKED_FRAMES; i++)
+    {
+        process_events();
+        render_frame();
+        AllocationCounts counts = get_last_frame_allocations();
+        INFO("idle frame " << i << " allocated " << counts.bytes << " bytes");
+        CHECK(counts.allocations == 0);
+    }
+}
+
+TEST_CASE("an idle frame does not allocate")
+{
+    REQUIRE(allocation_tracking_available());
+
+    std::string home = (std::filesystem::temp_directory_path() / "just_launch_doom_idle_frame_test").string();
+    std::string pwad_dir = home + "/wads";
+    std::filesystem::remove_all(home);
+    std::filesystem::create_directories(pwad_dir);
+    for (int i = 0; i < 50; i++)
+    {
+        std::ofstream(pwad_dir + "/a_pwad_file_with_a_long_name_" + std::to_string(i) + ".wad");
+    }
+    std::ofstream(pwad_dir + "/a_selected_pwad_with_a_long_name.wad");
+    std::ofstream(pwad_dir + "/a_selected_pwad_with_a_long_name.txt");
+
+    setenv("HOME", home.c_str(), 1);
+    write_idle_config(pwad_dir);
+    setenv("SDL_VIDEODRIVER", "dummy", 1);
+    setenv("SDL_RENDER_DRIVER", "software", 1);
+    REQUIRE(setup() == 0);
+
+    run_frames(WARMUP_FRAMES);
+    check_idle_frames();
+
+    // The cached labels and launch command rebuild once after a change, then the frame is idle again
+    config["selected_iwad"] = "/home/player/other/doom2.wad";
+    config["custom_params"] = "-skill 3";
+    run_frames(5);
+    check_idle_frames();
+
+    clean_up();
+    std::filesystem::remove_all(home);
+}
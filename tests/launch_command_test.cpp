@@ -172,3 +172,107 @@ TEST_CASE("build_display_names handles empty input")
     auto names = build_display_names(paths);
     CHECK(names.empty());
 }
+
+TEST_CASE("DisplayNameCache rebuilds only when the list changes")
+{
+    DisplayNameCache cache;
+    nlohmann::json paths = {"/dir1/doom.wad", "/dir2/doom.wad"};
+
+    CHECK(cache.update(paths));
+    uint64_t generation = cache.generation();
+    CHECK(cache.get("/dir2/doom.wad") == "doom.wad (2)");
+
+    CHECK_FALSE(cache.update(paths));
+    CHECK(cache.generation() == generation);
+
+    paths.push_back("/dir3/heretic.wad");
+    CHECK(cache.update(paths));
+    CHECK(cache.generation() > generation);
+    CHECK(cache.get("/dir3/heretic.wad") == "heretic.wad");
+}
+
+TEST_CASE("DisplayNameCache falls back to the filename for unknown paths")
+{
+    DisplayNameCache cache;
+    cache.rebuild({"/dir1/doom.wad"});
+    CHECK(cache.get("/elsewhere/plutonia.wad") == "plutonia.wad");
+}
+
+TEST_CASE("DisplayNameCache treats a missing list as empty")
+{
+    DisplayNameCache cache;
+    CHECK(cache.update(nlohmann::json()));
+    CHECK_FALSE(cache.update(nlohmann::json()));
+    CHECK_FALSE(cache.update(nlohmann::json::array()));
+}
+
+TEST_CASE("build_launch_command assembles executable, files, IWAD, params and config")
+{
+    nlohmann::json config = {
+        {"selected_executable", "/usr/bin/gzdoom"},
+        {"selected_iwad", "/wads/doom2.wad"},
+        {"selected_pwads", {"/pwads/maps.wad", "/pwads/patch.deh"}},
+        {"custom_params", "-skill 4"},
+        {"selected_config", "/cfg/gzdoom.ini"}};
+
+    std::string command = build_launch_command(config);
+    CHECK(command.rfind("\"/usr/bin/gzdoom\"", 0) == 0);
+    CHECK(command.find("-file \"/pwads/maps.wad\"") != std::string::npos);
+    CHECK(command.find("-deh \"/pwads/patch.deh\"") != std::string::npos);
+    CHECK(command.find("-iwad \"/wads/doom2.wad\"") != std::string::npos);
+    CHECK(command.find(" -skill 4") != std::string::npos);
+    CHECK(command.find("-config \"/cfg/gzdoom.ini\"") != std::string::npos);
+}
+
+TEST_CASE("build_launch_command tolerates missing fields")
+{
+    nlohmann::json config = {{"selected_executable", "/usr/bin/woof"}};
+    CHECK(build_launch_command(config) == "\"/usr/bin/woof\"");
+}
+
+TEST_CASE("normalize_launch_config replaces null and mistyped fields")
+{
+    nlohmann::json config = {{"selected_executable", "/usr/bin/woof"},
+                             {"selected_iwad", nullptr},
+                             {"selected_config", nullptr},
+                             {"custom_params", 3},
+                             {"selected_pwads", {"/pwads/a.wad", nullptr}},
+                             {"sdl_renderer", nullptr}};
+    CHECK_THROWS(build_launch_command(config));
+
+    normalize_launch_config(config);
+    CHECK(config["selected_iwad"] == "");
+    CHECK(config["custom_params"] == "");
+    CHECK(config["selected_pwads"] == nlohmann::json{"/pwads/a.wad"});
+    CHECK(config["sdl_renderer"] == "auto");
+    CHECK(config["sdl_renderer_inherit"] == false);
+    CHECK(build_launch_command(config).find("-file \"/pwads/a.wad\"") != std::string::npos);
+    CHECK(get_selected_file_paths(config).size() == 1);
+
+    nlohmann::json not_object = nullptr;
+    normalize_launch_config(not_object);
+    CHECK(build_launch_command(not_object).rfind("\"\"", 0) == 0);
+}
+
+TEST_CASE("get_selected_file_paths lists IWAD, PWADs and config in load order")
+{
+    nlohmann::json config = {
+        {"selected_iwad", "/wads/doom2.wad"},
+        {"selected_pwads", {"/pwads/b.wad", "/pwads/a.wad"}},
+        {"selected_config", "/cfg/gzdoom.ini"}};
+
+    std::vector<std::string> expected = {"/wads/doom2.wad", "/pwads/b.wad", "/pwads/a.wad", "/cfg/gzdoom.ini"};
+    CHECK(get_selected_file_paths(config) == expected);
+
+    config["selected_iwad"] = "";
+    config["selected_config"] = "";
+    CHECK(get_selected_file_paths(config).size() == 2);
+}
+
+TEST_CASE("format_file_metadata picks a unit and appends the date")
+{
+    CHECK(format_file_metadata(512, 0).rfind("512 bytes, modified ", 0) == 0);
+    CHECK(format_file_metadata(2048, 0).rfind("2.0 KB, modified ", 0) == 0);
+    CHECK(format_file_metadata(5 * 1024 * 1024 + 512 * 1024, 0).rfind("5.5 MB", 0) == 0);
+    CHECK(format_file_metadata(1536, 1700000000).size() == std::string("1.5 KB, modified 2023-11-14").size());
+}
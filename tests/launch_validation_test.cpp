@@ -0,0 +1,71 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "../src/launch_validation.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static const std::string test_dir = "/tmp/just_launch_doom_validation_test";
+
+static std::string write_file(const std::string &name, const std::string &content)
+{
+    fs::create_directories(test_dir);
+    std::string path = test_dir + "/" + name;
+    std::ofstream file(path, std::ios::binary);
+    file << content;
+    return path;
+}
+
+TEST_CASE("Valid WAD and PK3 headers pass")
+{
+    CHECK(check_launch_file(write_file("maps.wad", std::string("PWAD\0\0\0\0", 8))) == LaunchFileProblem::None);
+    CHECK(check_launch_file(write_file("DOOM2.WAD", std::string("IWAD\0\0\0\0", 8))) == LaunchFileProblem::None);
+    CHECK(check_launch_file(write_file("mod.pk3", std::string("PK\x03\x04rest", 8))) == LaunchFileProblem::None);
+    CHECK(check_launch_file(write_file("empty.pk3", std::string("PK\x05\x06", 4))) == LaunchFileProblem::None);
+    CHECK(check_launch_file(write_file("mod.pk7", std::string("7z\xBC\xAF\x27\x1C", 6))) == LaunchFileProblem::None);
+}
+
+TEST_CASE("Mismatched headers are reported as wrong type")
+{
+    CHECK(check_launch_file(write_file("fake.wad", "<html>not a wad</html>")) == LaunchFileProblem::WrongType);
+    CHECK(check_launch_file(write_file("fake.pk3", "PWAD0000")) == LaunchFileProblem::WrongType);
+    CHECK(check_launch_file(write_file("short.wad", "PW")) == LaunchFileProblem::WrongType);
+    CHECK(check_launch_file(write_file("zero.wad", "")) == LaunchFileProblem::WrongType);
+}
+
+TEST_CASE("Files without a magic number are accepted")
+{
+    CHECK(check_launch_file(write_file("patch.deh", "Patch File for DeHackEd")) == LaunchFileProblem::None);
+    CHECK(check_launch_file(write_file("root.edf", "")) == LaunchFileProblem::None);
+}
+
+TEST_CASE("Missing files and directories are reported")
+{
+    CHECK(check_launch_file(test_dir + "/does_not_exist.wad") == LaunchFileProblem::Missing);
+
+    fs::create_directories(test_dir + "/folder.wad");
+    CHECK(check_launch_file(test_dir + "/folder.wad") == LaunchFileProblem::WrongType);
+}
+
+TEST_CASE("validate_launch_files returns only problems, in order")
+{
+    std::vector<std::string> paths = {
+        write_file("good.wad", "PWAD0000"),
+        test_dir + "/gone.wad",
+        write_file("bad.pk3", "nope"),
+        write_file("good.deh", "Patch")};
+
+    auto issues = validate_launch_files(paths);
+    REQUIRE(issues.size() == 2);
+    CHECK(issues[0].path == test_dir + "/gone.wad");
+    CHECK(issues[0].problem == LaunchFileProblem::Missing);
+    CHECK(issues[1].path == test_dir + "/bad.pk3");
+    CHECK(issues[1].problem == LaunchFileProblem::WrongType);
+
+    CHECK(validate_launch_files({}).empty());
+
+    fs::remove_all(test_dir);
+}
@@ -0,0 +1,54 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "../src/prefetch.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+static const std::string test_root = "/tmp/just_launch_doom_prefetch_test";
+
+static void write_file(const std::string &path, size_t bytes)
+{
+    fs::create_directories(fs::path(path).parent_path());
+    std::ofstream file(path, std::ios::binary);
+    file << std::string(bytes, 'x');
+}
+
+TEST_CASE("prefetch_file advises up to the file size or the limit")
+{
+    fs::remove_all(test_root);
+    write_file(test_root + "/doom2.wad", 4096);
+
+    CHECK(prefetch_file(test_root + "/doom2.wad", 1 << 20) == 4096);
+    CHECK(prefetch_file(test_root + "/doom2.wad", 1000) == 1000);
+    CHECK(prefetch_file(test_root + "/missing.wad", 1 << 20) == 0);
+    CHECK(prefetch_file(test_root, 1 << 20) == 0); // Directories are skipped
+
+    fs::remove_all(test_root);
+}
+
+TEST_CASE("prefetch_files advises the list in the background within its budget")
+{
+    fs::remove_all(test_root);
+    write_file(test_root + "/doom2.wad", 4096);
+    write_file(test_root + "/map01.wad", 4096);
+    write_file(test_root + "/map02.wad", 4096);
+
+    prefetch_files({test_root + "/doom2.wad", test_root + "/map01.wad", test_root + "/map02.wad"}, 6000);
+    PrefetchStats stats = get_prefetch_stats();
+    for (int i = 0; i < 500 && stats.in_progress; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        stats = get_prefetch_stats();
+    }
+    CHECK_FALSE(stats.in_progress);
+    CHECK(stats.files == 2);
+    CHECK(stats.bytes_advised == 6000);
+
+    shutdown_prefetch();
+    fs::remove_all(test_root);
+}
@@ -0,0 +1,82 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "../src/nlohmann/json.hpp"
+#include "../src/profile_utils.h"
+
+static nlohmann::json make_config()
+{
+    return {
+        {"selected_executable", "/usr/bin/gzdoom"},
+        {"selected_iwad", "/wads/doom2.wad"},
+        {"selected_pwads", {"/pwads/sunlust.wad", "/pwads/music.wad"}},
+        {"selected_config", "/cfg/gzdoom.ini"},
+        {"custom_params", "-skill 4"},
+        {"pwad_directories", {"/pwads"}}};
+}
+
+TEST_CASE("save_profile snapshots only the selection fields")
+{
+    nlohmann::json config = make_config();
+
+    save_profile(config, "Sunlust");
+
+    REQUIRE(config["profiles"].contains("Sunlust"));
+    const auto &profile = config["profiles"]["Sunlust"];
+    CHECK(profile["selected_executable"] == "/usr/bin/gzdoom");
+    CHECK(profile["selected_iwad"] == "/wads/doom2.wad");
+    CHECK(profile["selected_pwads"].size() == 2);
+    CHECK(profile["selected_config"] == "/cfg/gzdoom.ini");
+    CHECK(profile["custom_params"] == "-skill 4");
+    CHECK_FALSE(profile.contains("pwad_directories"));
+}
+
+TEST_CASE("apply_profile restores every selection field at once")
+{
+    nlohmann::json config = make_config();
+    save_profile(config, "Sunlust");
+
+    config["selected_executable"] = "/usr/bin/dsda-doom";
+    config["selected_iwad"] = "/wads/plutonia.wad";
+    config["selected_pwads"] = nlohmann::json::array();
+    config["selected_config"] = "";
+    config["custom_params"] = "";
+
+    CHECK(apply_profile(config, "Sunlust"));
+    CHECK(config["selected_executable"] == "/usr/bin/gzdoom");
+    CHECK(config["selected_iwad"] == "/wads/doom2.wad");
+    CHECK(config["selected_pwads"] == nlohmann::json({"/pwads/sunlust.wad", "/pwads/music.wad"}));
+    CHECK(config["selected_config"] == "/cfg/gzdoom.ini");
+    CHECK(config["custom_params"] == "-skill 4");
+}
+
+TEST_CASE("apply_profile keeps current values for fields the profile lacks")
+{
+    nlohmann::json config = make_config();
+    config["profiles"] = {{"Old", {{"selected_iwad", "/wads/tnt.wad"}}}};
+
+    CHECK(apply_profile(config, "Old"));
+    CHECK(config["selected_iwad"] == "/wads/tnt.wad");
+    CHECK(config["selected_executable"] == "/usr/bin/gzdoom");
+    CHECK(config["custom_params"] == "-skill 4");
+}
+
+TEST_CASE("apply_profile fails for unknown profiles")
+{
+    nlohmann::json config = make_config();
+    CHECK_FALSE(apply_profile(config, "Missing"));
+    CHECK(config == make_config());
+}
+
+TEST_CASE("delete_profile and get_profile_names")
+{
+    nlohmann::json config = make_config();
+    CHECK(get_profile_names(config).empty());
+    CHECK_FALSE(delete_profile(config, "Nope"));
+
+    save_profile(config, "B");
+    save_profile(config, "A");
+    CHECK(get_profile_names(config) == std::vector<std::string>{"A", "B"});
+
+    CHECK(delete_profile(config, "A"));
+    CHECK(get_profile_names(config) == std::vector<std::string>{"B"});
+}
@@ -0,0 +1,186 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "../src/pwad_index.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static const std::string test_root = (fs::temp_directory_path() / "just_launch_doom_pwad_index_test").string();
+static const std::string index_path = test_root + "/index/pwad_index.json";
+
+static void touch(const std::string &path)
+{
+    fs::create_directories(fs::path(path).parent_path());
+    std::ofstream(path) << "content";
+}
+
+static PwadScanRoot make_root(const std::string &directory)
+{
+    PwadScanRoot root;
+    root.directory = directory;
+    return root;
+}
+
+static size_t total_files(const PwadIndexedScan &scan)
+{
+    size_t files = 0;
+    for (const auto &listing : scan.listings)
+    {
+        files += listing.size();
+    }
+    return files;
+}
+
+static PwadScanPolicy local_index_policy(bool prefer_index)
+{
+    PwadScanPolicy policy;
+    policy.local.collect_metadata = true;
+    policy.prefer_index = prefer_index;
+    policy.index_local_roots = true;
+    policy.index_path = index_path;
+    return policy;
+}
+
+TEST_CASE("detect_filesystem names the filesystem of a local directory")
+{
+    fs::create_directories(test_root);
+    FilesystemInfo info = detect_filesystem(test_root);
+    CHECK_FALSE(info.type.empty());
+    fs::remove_all(test_root);
+}
+
+TEST_CASE("PwadIndex round-trips files and metadata through its file")
+{
+    fs::remove_all(test_root);
+    PwadScanRoot root = make_root("/share/wads");
+    PwadList scanned;
+    scanned.add("/share/wads", "/share/wads/a.wad", "/share/wads/a.txt");
+    scanned.add("/other", "/other/b.wad", "");
+    scanned.add("/share/wads", "/share/wads/c.wad", "");
+    scanned.set_metadata(2, 1234, 1700000000);
+
+    PwadIndex index;
+    index.put(root, scanned, 42);
+    REQUIRE(index.save(index_path));
+
+    PwadIndex loaded;
+    REQUIRE(loaded.load(index_path));
+    CHECK(loaded.contains(root));
+    CHECK(loaded.indexed_at(root) == 42);
+    PwadList result;
+    loaded.get(root, result);
+    REQUIRE(result.size() == 2);
+    CHECK(std::string(result.filepath(0)) == "/share/wads/a.wad");
+    CHECK(std::string(result.txt_filepath(0)) == "/share/wads/a.txt");
+    CHECK_FALSE(result.has_metadata(0));
+    CHECK(result.file_size(1) == 1234);
+    CHECK(result.modified_time(1) == 1700000000);
+    CHECK(result.directory(1) == "/share/wads");
+
+    // Entries only match the root settings they were scanned with
+    PwadScanRoot recursive = root;
+    recursive.recursive = true;
+    CHECK_FALSE(loaded.contains(recursive));
+
+    loaded.retain({make_root("/elsewhere")});
+    CHECK_FALSE(loaded.contains(root));
+
+    std::ofstream(index_path) << "not json";
+    CHECK_FALSE(loaded.load(index_path));
+    fs::remove_all(test_root);
+}
+
+TEST_CASE("scan_pwad_roots_indexed serves indexed roots first and rescans on revalidation")
+{
+    fs::remove_all(test_root);
+    touch(test_root + "/wads/one.wad");
+    std::vector<PwadScanRoot> roots = {make_root(test_root + "/wads")};
+
+    // Nothing indexed yet: scanned live, and the index is written
+    PwadIndexedScan first = scan_pwad_roots_indexed(roots, local_index_policy(true));
+    CHECK(total_files(first) == 1);
+    CHECK_FALSE(first.served_from_index);
+    REQUIRE(first.roots.size() == 1);
+    CHECK(first.roots[0].files == 1);
+    CHECK_FALSE(first.roots[0].from_index);
+    CHECK(first.roots[0].indexed_at > 0);
+    CHECK(fs::exists(index_path));
+
+    // A new file is not seen while the root is served from the index
+    touch(test_root + "/wads/two.wad");
+    PwadIndexedScan cached = scan_pwad_roots_indexed(roots, local_index_policy(true));
+    CHECK(cached.served_from_index);
+    CHECK(cached.roots[0].from_index);
+    CHECK(total_files(cached) == 1);
+    CHECK(cached.listings[0].has_metadata(0));
+
+    // Revalidation scans it and updates the index
+    PwadIndexedScan fresh = scan_pwad_roots_indexed(roots, local_index_policy(false));
+    CHECK_FALSE(fresh.served_from_index);
+    CHECK(total_files(fresh) == 2);
+    CHECK(total_files(scan_pwad_roots_indexed(roots, local_index_policy(true))) == 2);
+
+    // An unreachable root keeps its last good entry
+    fs::remove_all(test_root + "/wads");
+    CHECK(total_files(scan_pwad_roots_indexed(roots, local_index_policy(false))) == 0);
+    CHECK(total_files(scan_pwad_roots_indexed(roots, local_index_policy(true))) == 2);
+    fs::remove_all(test_root);
+}
+
+TEST_CASE("scan_pwad_roots_indexed leaves local roots out of the index by default")
+{
+    fs::remove_all(test_root);
+    touch(test_root + "/wads/one.wad");
+    PwadScanPolicy policy;
+    policy.index_path = index_path;
+
+    PwadIndexedScan scan = scan_pwad_roots_indexed({make_root(test_root + "/wads")}, policy);
+    CHECK(total_files(scan) == 1);
+    if (scan.roots[0].filesystem.kind == FilesystemKind::Local)
+    {
+        CHECK_FALSE(fs::exists(index_path));
+    }
+    fs::remove_all(test_root);
+}
+
+TEST_CASE("concurrent indexed scans leave a complete index")
+{
+    fs::remove_all(test_root);
+    for (int i = 0; i < 20; i++)
+    {
+        touch(test_root + "/a/a" + std::to_string(i) + ".wad");
+        touch(test_root + "/b/b" + std::to_string(i) + ".wad");
+    }
+    std::vector<PwadScanRoot> roots = {make_root(test_root + "/a"), make_root(test_root + "/b")};
+
+    // Like a superseded background scan still finishing while a newer one runs
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+        threads.emplace_back([&]
+                             {
+                                 for (int i = 0; i < 10; i++)
+                                 {
+                                     scan_pwad_roots_indexed(roots, local_index_policy(false));
+                                 } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    PwadIndex index;
+    REQUIRE(index.load(index_path));
+    CHECK(index.contains(roots[0]));
+    CHECK(index.contains(roots[1]));
+    PwadList served;
+    index.get(roots[0], served);
+    index.get(roots[1], served);
+    CHECK(served.size() == 40);
+    CHECK_FALSE(fs::exists(index_path + ".tmp"));
+    fs::remove_all(test_root);
+}
@@ -0,0 +1,107 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "../src/pwad_list.h"
+#include <string>
+
+TEST_CASE("PwadList stores paths, filenames and companion text files")
+{
+    PwadList pwads;
+    pwads.add("/wads", "/wads/sunlust.wad", "/wads/sunlust.txt");
+    pwads.add("/wads", "/wads/lonely.pk3", "");
+
+    REQUIRE(pwads.size() == 2);
+    CHECK(std::string(pwads.filepath(0)) == "/wads/sunlust.wad");
+    CHECK(std::string(pwads.filename(0)) == "sunlust.wad");
+    CHECK(pwads.has_txt(0));
+    CHECK(std::string(pwads.txt_filepath(0)) == "/wads/sunlust.txt");
+    CHECK_FALSE(pwads.has_txt(1));
+    CHECK(std::string(pwads.txt_filepath(1)).empty());
+}
+
+TEST_CASE("PwadList interns directories")
+{
+    PwadList pwads;
+    pwads.add("/a", "/a/one.wad", "");
+    pwads.add("/b", "/b/two.wad", "");
+    pwads.add("/a", "/a/three.wad", "");
+
+    CHECK(pwads.directories().size() == 2);
+    CHECK(pwads.directory_index(0) == pwads.directory_index(2));
+    CHECK(pwads.directory_index(0) != pwads.directory_index(1));
+    CHECK(pwads.directory(2) == "/a");
+}
+
+TEST_CASE("PwadList handles Windows separators and bare filenames")
+{
+    PwadList pwads;
+    pwads.add("C:\\wads", "C:\\wads\\doom.wad", "");
+    pwads.add("", "bare.wad", "");
+
+    CHECK(std::string(pwads.filename(0)) == "doom.wad");
+    CHECK(std::string(pwads.filename(1)) == "bare.wad");
+}
+
+TEST_CASE("PwadList selection flags and clear")
+{
+    PwadList pwads;
+    pwads.add("/wads", "/wads/one.wad", "");
+    pwads.add("/wads", "/wads/two.wad", "");
+
+    CHECK_FALSE(pwads.selected(0));
+    pwads.set_selected(1, true);
+    CHECK(pwads.selected(1));
+    CHECK_FALSE(pwads.selected(0));
+    pwads.set_selected(1, false);
+    CHECK_FALSE(pwads.selected(1));
+
+    pwads.clear();
+    CHECK(pwads.empty());
+    CHECK(pwads.directories().empty());
+}
+
+TEST_CASE("PwadList append rebases offsets and re-interns directories")
+{
+    PwadList first;
+    first.add("/a", "/a/one.wad", "");
+
+    PwadList second;
+    second.add("/b", "/b/two.wad", "/b/two.txt");
+    second.add("/a", "/a/three.wad", "");
+    second.set_selected(1, true);
+
+    first.append(second);
+    REQUIRE(first.size() == 3);
+    CHECK(std::string(first.filepath(1)) == "/b/two.wad");
+    CHECK(std::string(first.filename(1)) == "two.wad");
+    CHECK(std::string(first.txt_filepath(1)) == "/b/two.txt");
+    CHECK_FALSE(first.has_txt(2));
+    CHECK(first.selected(2));
+    CHECK(first.directories().size() == 2);
+    CHECK(first.directory_index(2) == first.directory_index(0));
+}
+
+TEST_CASE("PwadList metadata is optional and survives append")
+{
+    PwadList pwads;
+    pwads.add("/wads", "/wads/one.wad", "");
+    pwads.add("/wads", "/wads/two.wad", "");
+    CHECK_FALSE(pwads.has_metadata(0));
+    CHECK(pwads.file_size(0) == 0);
+
+    pwads.set_metadata(1, 4096, 1700000000);
+    CHECK_FALSE(pwads.has_metadata(0));
+    CHECK(pwads.has_metadata(1));
+    CHECK(pwads.file_size(1) == 4096);
+    CHECK(pwads.modified_time(1) == 1700000000);
+
+    PwadList more;
+    more.add("/more", "/more/three.wad", "");
+    more.set_metadata(0, 12, 34);
+    pwads.add("/wads", "/wads/four.wad", "");
+    pwads.append(more);
+    REQUIRE(pwads.size() == 4);
+    CHECK_FALSE(pwads.has_metadata(2));
+    CHECK(pwads.has_metadata(3));
+    CHECK(pwads.file_size(3) == 12);
+    CHECK(pwads.modified_time(3) == 34);
+}
@@ -0,0 +1,383 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "../src/pwad_scan.h"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static const std::string test_root = "/tmp/just_launch_doom_scan_test";
+
+static void touch(const std::string &path)
+{
+    fs::create_directories(fs::path(path).parent_path());
+    std::ofstream file(path);
+    file << "content";
+}
+
+// Record index of the file with this name, or -1
+static int find_pwad(const PwadList &pwads, const std::string &filename)
+{
+    for (size_t i = 0; i < pwads.size(); i++)
+    {
+        if (filename == pwads.filename(i))
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+TEST_CASE("scan_pwad_directories lists only PWAD files")
+{
+    fs::remove_all(test_root);
+    touch(test_root + "/a/maps.wad");
+    touch(test_root + "/a/patch.deh");
+    touch(test_root + "/a/root.edf");
+    touch(test_root + "/a/readme.md");
+    touch(test_root + "/a/screenshot.png");
+    fs::create_directories(test_root + "/a/folder.wad");
+
+    auto pwads = scan_pwad_directories({test_root + "/a"});
+    CHECK(pwads.size() == 3);
+    CHECK(find_pwad(pwads, "maps.wad") >= 0);
+    CHECK(find_pwad(pwads, "patch.deh") >= 0);
+    CHECK(find_pwad(pwads, "root.edf") >= 0);
+    CHECK(find_pwad(pwads, "folder.wad") < 0);
+
+    for (size_t i = 0; i < pwads.size(); i++)
+    {
+        CHECK_FALSE(pwads.selected(i));
+        CHECK(pwads.directory(i) == test_root + "/a");
+    }
+}
+
+TEST_CASE("scan_pwad_directories pairs companion text files")
+{
+    fs::remove_all(test_root);
+    touch(test_root + "/a/sunlust.wad");
+    touch(test_root + "/a/sunlust.txt");
+    touch(test_root + "/a/lonely.pk3");
+
+    auto pwads = scan_pwad_directories({test_root + "/a"});
+    int sunlust = find_pwad(pwads, "sunlust.wad");
+    REQUIRE(sunlust >= 0);
+    CHECK(pwads.has_txt(sunlust));
+    CHECK(pwads.txt_filepath(sunlust) == test_root + "/a/sunlust.txt");
+    int lonely = find_pwad(pwads, "lonely.pk3");
+    REQUIRE(lonely >= 0);
+    CHECK_FALSE(pwads.has_txt(lonely));
+    CHECK(std::string(pwads.txt_filepath(lonely)).empty());
+}
+
+TEST_CASE("scan_pwad_directories records the source directory and skips missing ones")
+{
+    fs::remove_all(test_root);
+    touch(test_root + "/a/one.wad");
+    touch(test_root + "/b/two.wad");
+
+    auto pwads = scan_pwad_directories({test_root + "/a", test_root + "/missing", test_root + "/b"});
+    REQUIRE(pwads.size() == 2);
+    CHECK(pwads.directory(find_pwad(pwads, "one.wad")) == test_root + "/a");
+    CHECK(pwads.directory(find_pwad(pwads, "two.wad")) == test_root + "/b");
+    CHECK(pwads.directories().size() == 2);
+
+    fs::remove_all(test_root);
+}
+
+TEST_CASE("glob_match supports wildcards, case folding and paths")
+{
+    CHECK(glob_match("*.bak", "old.BAK"));
+    CHECK(glob_match("backup", "backup"));
+    CHECK(glob_match("*/backup/*", "author/backup/map.wad"));
+    CHECK(glob_match("map??.wad", "map01.wad"));
+    CHECK(glob_match("*", ""));
+    CHECK_FALSE(glob_match("map??.wad", "map1.wad"));
+    CHECK_FALSE(glob_match("*.wad", "map.pk3"));
+    CHECK_FALSE(glob_match("backup", "backups"));
+}
+
+TEST_CASE("scan_pwad_roots descends only into recursive roots, up to max_depth")
+{
+    fs::remove_all(test_root);
+    touch(test_root + "/lib/top.wad");
+    touch(test_root + "/lib/author/one.wad");
+    touch(test_root + "/lib/author/1994/two.wad");
+    touch(test_root + "/lib/author/1994/deep/three.wad");
+    touch(test_root + "/lib/other/four.pk3");
+
+    PwadScanRoot root;
+    root.directory = test_root + "/lib";
+    CHECK(scan_pwad_roots({root}).size() == 1);
+
+    root.recursive = true;
+    auto pwads = scan_pwad_roots({root});
+    CHECK(pwads.size() == 5);
+
+    root.max_depth = 1;
+    pwads = scan_pwad_roots({root});
+    CHECK(pwads.size() == 3);
+    CHECK(find_pwad(pwads, "one.wad") >= 0);
+    CHECK(find_pwad(pwads, "four.pk3") >= 0);
+    CHECK(find_pwad(pwads, "two.wad") < 0);
+
+    fs::remove_all(test_root);
+}
+
+TEST_CASE("scan_pwad_roots groups subdirectory files under their root and pairs text files")
+{
+    fs::remove_all(test_root);
+    touch(test_root + "/lib/author/one.wad");
+    touch(test_root + "/lib/author/one.txt");
+    touch(test_root + "/flat/two.wad");
+
+    PwadScanRoot lib;
+    lib.directory = test_root + "/lib";
+    lib.recursive = true;
+    PwadScanRoot flat;
+    flat.directory = test_root + "/flat";
+
+    auto pwads = scan_pwad_roots({lib, flat});
+    REQUIRE(pwads.size() == 2);
+    int one = find_pwad(pwads, "one.wad");
+    REQUIRE(one >= 0);
+    CHECK(pwads.directory(one) == test_root + "/lib");
+    CHECK(std::string(pwads.filepath(one)) == test_root + "/lib/author/one.wad");
+    CHECK(std::string(pwads.txt_filepath(one)) == test_root + "/lib/author/one.txt");
+    CHECK(pwads.directory(find_pwad(pwads, "two.wad")) == test_root + "/flat");
+
+    fs::remove_all(test_root);
+}
+
+TEST_CASE("scan_pwad_roots applies exclude globs to directories and files")
+{
+    fs::remove_all(test_root);
+    touch(test_root + "/lib/keep.wad");
+    touch(test_root + "/lib/old.wad");
+    touch(test_root + "/lib/backup/copy.wad");
+    touch(test_root + "/lib/author/backup/copy2.wad");
+    touch(test_root + "/lib/author/map.wad");
+
+    PwadScanRoot root;
+    root.directory = test_root + "/lib";
+    root.recursive = true;
+    root.exclude = {"backup", "old.*"};
+
+    auto pwads = scan_pwad_roots({root});
+    CHECK(pwads.size() == 2);
+    CHECK(find_pwad(pwads, "keep.wad") >= 0);
+    CHECK(find_pwad(pwads, "map.wad") >= 0);
+
+    root.exclude = {"author/*"};
+    pwads = scan_pwad_roots({root});
+    CHECK(find_pwad(pwads, "map.wad") < 0);
+    CHECK(find_pwad(pwads, "copy.wad") >= 0);
+
+    fs::remove_all(test_root);
+}
+
+#ifndef _WIN32
+TEST_CASE("scan_pwad_roots survives symlink loops and lists each directory once")
+{
+    fs::remove_all(test_root);
+    touch(test_root + "/lib/a/one.wad");
+    touch(test_root + "/lib/b/two.wad");
+    fs::create_directory_symlink(test_root + "/lib", test_root + "/lib/a/loop");
+    fs::create_directory_symlink(test_root + "/lib/b", test_root + "/lib/a/b_again");
+
+    PwadScanRoot root;
+    root.directory = test_root + "/lib";
+    root.recursive = true;
+    root.max_depth = 64;
+
+    auto pwads = scan_pwad_roots({root});
+    CHECK(pwads.size() == 2);
+
+    // The same directory registered twice is only listed once
+    auto twice = scan_pwad_directories({test_root + "/lib/a", test_root + "/lib/a"});
+    CHECK(twice.size() == 1);
+
+    fs::remove_all(test_root);
+}
+#endif
+
+TEST_CASE("scan_pwad_roots scans many subtrees concurrently")
+{
+    fs::remove_all(test_root);
+    for (int i = 0; i < 40; i++)
+    {
+        for (int j = 0; j < 5; j++)
+        {
+            touch(test_root + "/lib/author" + std::to_string(i) + "/sub/map" + std::to_string(j) + ".wad");
+        }
+    }
+
+    PwadScanRoot root;
+    root.directory = test_root + "/lib";
+    root.recursive = true;
+    auto pwads = scan_pwad_roots({root});
+    CHECK(pwads.size() == 200);
+    CHECK(pwads.directories().size() == 1);
+
+    fs::remove_all(test_root);
+}
+
+TEST_CASE("a checkpoint returning false abandons the scan")
+{
+    fs::remove_all(test_root);
+    touch(test_root + "/flat/one.wad");
+    for (int i = 0; i < 10; i++)
+    {
+        touch(test_root + "/lib/author" + std::to_string(i) + "/map.wad");
+    }
+    touch(test_root + "/later/two.wad");
+
+    PwadScanRoot flat;
+    flat.directory = test_root + "/flat";
+    PwadScanRoot lib;
+    lib.directory = test_root + "/lib";
+    lib.recursive = true;
+    PwadScanRoot later;
+    later.directory = test_root + "/later";
+
+    // Allow the first root and the start of the second, then stop
+    std::atomic<int> calls(0);
+    PwadScanOptions options;
+    options.checkpoint = [&]
+    { return ++calls <= 2; };
+    std::vector<PwadRootScanStats> stats;
+    auto pwads = scan_pwad_roots({flat, lib, later}, options, &stats);
+
+    REQUIRE(stats.size() == 3);
+    CHECK(stats[0].found);
+    CHECK_FALSE(stats[1].found);
+    CHECK_FALSE(stats[2].found);
+    CHECK(find_pwad(pwads, "one.wad") >= 0);
+    CHECK(find_pwad(pwads, "two.wad") < 0);
+    CHECK(pwads.size() < 3);
+
+    fs::remove_all(test_root);
+}
+
+TEST_CASE("get_pwad_scan_roots reads per-directory options")
+{
+    nlohmann::json config = {
+        {"pwad_directories", {"/wads/flat", "/wads/lib"}},
+        {"pwad_directory_options", {{"/wads/lib", {{"recursive", true}, {"max_depth", 3}, {"exclude", {"backup", ""}}}}}}};
+
+    auto roots = get_pwad_scan_roots(config);
+    REQUIRE(roots.size() == 2);
+    CHECK(roots[0].directory == "/wads/flat");
+    CHECK_FALSE(roots[0].recursive);
+    CHECK(roots[1].recursive);
+    CHECK(roots[1].max_depth == 3);
+    REQUIRE(roots[1].exclude.size() == 1);
+    CHECK(roots[1].exclude[0] == "backup");
+
+    CHECK(get_pwad_scan_roots(nlohmann::json::object()).empty());
+}
+
+TEST_CASE("get_pwad_scan_roots falls back to the defaults for options of the wrong type")
+{
+    nlohmann::json config = {
+        {"pwad_directories", {"/wads/lib"}},
+        {"pwad_directory_options", {{"/wads/lib", {{"recursive", "yes"}, {"max_depth", "8"}, {"exclude", "backup"}}}}}};
+
+    std::vector<PwadScanRoot> roots;
+    CHECK_NOTHROW(roots = get_pwad_scan_roots(config));
+    REQUIRE(roots.size() == 1);
+    CHECK_FALSE(roots[0].recursive);
+    CHECK(roots[0].max_depth == PwadScanRoot().max_depth);
+    CHECK(roots[0].exclude.empty());
+}
+
+static std::vector<std::string> sorted_paths(const PwadList &pwads)
+{
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < pwads.size(); i++)
+    {
+        paths.push_back(std::string(pwads.filepath(i)) + "|" + pwads.txt_filepath(i));
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+TEST_CASE("both listing backends find the same files")
+{
+    fs::remove_all(test_root);
+    touch(test_root + "/lib/maps.wad");
+    touch(test_root + "/lib/maps.txt");
+    touch(test_root + "/lib/.hidden.wad");
+    touch(test_root + "/lib/author/sub/deep.pk3");
+    touch(test_root + "/lib/readme.md");
+#ifndef _WIN32
+    // Symlinks report DT_LNK, so their type comes from the statx fallback
+    fs::create_symlink(test_root + "/lib/maps.wad", test_root + "/lib/linked.wad");
+    fs::create_directory_symlink(test_root + "/lib/author", test_root + "/linked_author");
+    fs::create_symlink(test_root + "/lib/missing.wad", test_root + "/lib/dangling.wad");
+#endif
+
+    PwadScanRoot root;
+    root.directory = test_root + "/lib";
+    root.recursive = true;
+    auto std_paths = sorted_paths(scan_pwad_roots({root}, PwadScanOptions{PwadScanBackend::StdFilesystem}));
+    auto getdents_paths = sorted_paths(scan_pwad_roots({root}, PwadScanOptions{PwadScanBackend::Getdents}));
+    CHECK(std_paths == getdents_paths);
+#ifndef _WIN32
+    CHECK(std_paths.size() == 4);
+#endif
+
+    PwadScanRoot linked;
+    linked.directory = test_root + "/linked_author";
+    linked.recursive = true;
+    CHECK(scan_pwad_roots({linked}, PwadScanOptions{PwadScanBackend::Getdents}).size() ==
+          scan_pwad_roots({linked}, PwadScanOptions{PwadScanBackend::StdFilesystem}).size());
+
+    fs::remove_all(test_root);
+}
+
+TEST_CASE("scan_pwad_roots collects sizes and dates only when asked")
+{
+    fs::remove_all(test_root);
+    touch(test_root + "/a/small.wad");
+    std::ofstream(test_root + "/a/big.wad") << std::string(5000, 'x');
+
+    auto plain = scan_pwad_directories({test_root + "/a"});
+    REQUIRE(plain.size() == 2);
+    CHECK_FALSE(plain.has_metadata(0));
+
+    PwadScanOptions options;
+    options.collect_metadata = true;
+    auto pwads = scan_pwad_directories({test_root + "/a"}, options);
+    int big = find_pwad(pwads, "big.wad");
+    REQUIRE(big >= 0);
+    CHECK(pwads.has_metadata(big));
+    CHECK(pwads.file_size(big) == 5000);
+    CHECK(pwads.modified_time(big) > 0);
+    CHECK(pwads.file_size(find_pwad(pwads, "small.wad")) == fs::file_size(test_root + "/a/small.wad"));
+}
+
+TEST_CASE("scan_pwad_directories pairs text files in any letter case")
+{
+    fs::remove_all(test_root);
+    touch(test_root + "/a/lower.wad");
+    touch(test_root + "/a/LOWER.TXT");
+    touch(test_root + "/a/MIXED.WAD");
+    touch(test_root + "/a/mixed.txt");
+    touch(test_root + "/a/both.wad");
+    touch(test_root + "/a/BOTH.txt");
+    touch(test_root + "/a/both.txt");
+    touch(test_root + "/a/notes.wad");
+    fs::create_directories(test_root + "/a/notes.txt"); // A directory is not a text file
+
+    auto pwads = scan_pwad_directories({test_root + "/a"});
+    REQUIRE(pwads.size() == 4);
+    CHECK(pwads.txt_filepath(find_pwad(pwads, "lower.wad")) == test_root + "/a/LOWER.TXT");
+    CHECK(pwads.txt_filepath(find_pwad(pwads, "MIXED.WAD")) == test_root + "/a/mixed.txt");
+    CHECK(pwads.txt_filepath(find_pwad(pwads, "both.wad")) == test_root + "/a/both.txt");
+    CHECK_FALSE(pwads.has_txt(find_pwad(pwads, "notes.wad")));
+}
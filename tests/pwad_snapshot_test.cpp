@@ -0,0 +1,120 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "../src/pwad_snapshot.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+static PwadRootStatus root_status(const std::string &directory)
+{
+    PwadRootStatus status;
+    status.directory = directory;
+    return status;
+}
+
+// A scan of two roots, /a with the given files and /b with one file
+static PwadIndexedScan make_scan(const std::vector<std::string> &a_files)
+{
+    PwadIndexedScan scan;
+    scan.roots = {root_status("/a"), root_status("/b")};
+    scan.listings.resize(2);
+    for (const auto &file : a_files)
+    {
+        scan.listings[0].add("/a", "/a/" + file, "");
+    }
+    scan.listings[1].add("/b", "/b/two.wad", "");
+    return scan;
+}
+
+TEST_CASE("snapshots list every root's files in root order")
+{
+    PwadSnapshotPtr snapshot = make_pwad_snapshot(nullptr, make_scan({"one.wad"}));
+    CHECK(snapshot->version() == 1);
+    REQUIRE(snapshot->listings().size() == 2);
+    CHECK(snapshot->listings()[0]->directory == "/a");
+    CHECK(snapshot->listings()[1]->directory == "/b");
+
+    CHECK(std::string(snapshot->listings()[0]->files.filepath(0)) == "/a/one.wad");
+    CHECK(std::string(snapshot->listings()[1]->files.filepath(0)) == "/b/two.wad");
+    CHECK(snapshot->size() == 2);
+    CHECK(snapshot->record(0, 0) == 0);
+    CHECK(snapshot->record(1, 0) == 1);
+    CHECK(snapshot->roots().size() == 2);
+}
+
+TEST_CASE("roots without files get no listing and no record numbers")
+{
+    PwadSnapshotPtr snapshot = make_pwad_snapshot(nullptr, make_scan({}));
+    REQUIRE(snapshot->listings().size() == 1);
+    CHECK(snapshot->listings()[0]->directory == "/b");
+    CHECK(snapshot->size() == 1);
+    CHECK(snapshot->record(0, 0) == 0);
+    CHECK(snapshot->roots().size() == 2);
+}
+
+TEST_CASE("unchanged roots share their listing with the previous snapshot")
+{
+    PwadSnapshotPtr first = make_pwad_snapshot(nullptr, make_scan({"one.wad"}));
+    PwadSnapshotPtr same = make_pwad_snapshot(first.get(), make_scan({"one.wad"}));
+    CHECK(same->version() == 2);
+    CHECK(same->same_files_as(*first));
+
+    PwadSnapshotPtr changed = make_pwad_snapshot(same.get(), make_scan({"one.wad", "three.wad"}));
+    CHECK_FALSE(changed->same_files_as(*same));
+    CHECK(changed->listings()[0] != same->listings()[0]); // /a was copied
+    CHECK(changed->listings()[1] == same->listings()[1]); // /b was not
+    CHECK(changed->size() == 3);
+    CHECK(changed->record(1, 0) == 2);
+    CHECK(first->size() == 2); // Older snapshots are untouched
+}
+
+TEST_CASE("a change in size or date counts as changed")
+{
+    PwadIndexedScan scan = make_scan({"one.wad"});
+    PwadSnapshotPtr first = make_pwad_snapshot(nullptr, scan);
+    scan.listings[0].set_metadata(0, 100, 1700000000);
+    PwadSnapshotPtr touched = make_pwad_snapshot(first.get(), scan);
+    CHECK_FALSE(touched->same_files_as(*first));
+    CHECK(touched->listings()[1] == first->listings()[1]);
+}
+
+TEST_CASE("readers always load a whole published snapshot")
+{
+    PwadSnapshotSlot slot;
+    CHECK(slot.load() == nullptr);
+
+    std::atomic<bool> done(false);
+    std::thread writer([&]
+                       {
+                           PwadSnapshotPtr previous;
+                           for (int i = 0; i < 200; i++)
+                           {
+                               std::vector<std::string> files(i % 5 + 1, "");
+                               for (size_t f = 0; f < files.size(); f++)
+                               {
+                                   files[f] = "map" + std::to_string(f) + ".wad";
+                               }
+                               previous = make_pwad_snapshot(previous.get(), make_scan(files));
+                               slot.publish(previous);
+                           }
+                           done = true; });
+
+    bool consistent = true;
+    while (!done)
+    {
+        PwadSnapshotPtr snapshot = slot.load();
+        if (snapshot)
+        {
+            size_t files = 0;
+            for (const auto &listing : snapshot->listings())
+            {
+                files += listing->files.size();
+            }
+            consistent = consistent && files == snapshot->size();
+        }
+    }
+    writer.join();
+    CHECK(consistent);
+    CHECK(slot.load()->version() == 200);
+}
@@ -0,0 +1,217 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "../src/task_scheduler.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Occupies a worker until released, so tests can queue work behind it
+struct Gate
+{
+    std::atomic<bool> entered{false};
+    std::atomic<bool> open{false};
+
+    std::function<void()> task()
+    {
+        return [this]
+        {
+            entered = true;
+            while (!open)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        };
+    }
+
+    void wait_entered()
+    {
+        while (!entered)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+};
+
+TEST_CASE("runs every task, including tasks submitted by tasks")
+{
+    TaskScheduler scheduler(4);
+    std::atomic<int> count(0);
+    for (int i = 0; i < 100; i++)
+    {
+        scheduler.submit([&]
+                         {
+                             count++;
+                             for (int j = 0; j < 10; j++)
+                             {
+                                 scheduler.submit([&] { count++; });
+                             } });
+    }
+    scheduler.wait_idle();
+    CHECK(count == 1100);
+    CHECK(scheduler.stats().executed == 1100);
+}
+
+TEST_CASE("interactive tasks run before queued background tasks")
+{
+    TaskScheduler scheduler(1);
+    Gate gate;
+    scheduler.submit(gate.task());
+    gate.wait_entered();
+
+    std::mutex order_mutex;
+    std::vector<std::string> order;
+    auto record = [&](std::string name)
+    {
+        return [&, name]
+        {
+            std::lock_guard<std::mutex> lock(order_mutex);
+            order.push_back(name);
+        };
+    };
+    scheduler.submit(record("background"), TaskPriority::Background);
+    scheduler.submit(record("interactive"), TaskPriority::Interactive);
+    scheduler.submit(record("background"), TaskPriority::Background);
+    scheduler.submit(record("interactive"), TaskPriority::Interactive);
+    gate.open = true;
+    scheduler.wait_idle();
+
+    REQUIRE(order.size() == 4);
+    CHECK(order[0] == "interactive");
+    CHECK(order[1] == "interactive");
+    CHECK(order[2] == "background");
+    CHECK(order[3] == "background");
+}
+
+TEST_CASE("tasks cancelled before they start are dropped")
+{
+    TaskScheduler scheduler(1);
+    Gate gate;
+    scheduler.submit(gate.task());
+    gate.wait_entered();
+
+    std::atomic<int> ran(0);
+    CancellationToken token;
+    CancellationToken copy = token;
+    scheduler.submit([&] { ran++; }, TaskPriority::Background, token);
+    scheduler.submit([&] { ran++; }, TaskPriority::Background, token);
+    scheduler.submit([&] { ran++; });
+    copy.cancel(); // Copies share the flag
+    CHECK(token.cancelled());
+    gate.open = true;
+    scheduler.wait_idle();
+
+    CHECK(ran == 1);
+    CHECK(scheduler.stats().cancelled == 2);
+}
+
+TEST_CASE("idle workers steal from a busy worker's deque")
+{
+    TaskScheduler scheduler(2);
+    std::atomic<int> count(0);
+    scheduler.submit([&]
+                     {
+                         for (int i = 0; i < 20; i++)
+                         {
+                             scheduler.submit([&]
+                                              {
+                                                  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                                                  count++; });
+                         } });
+    scheduler.wait_idle();
+    CHECK(count == 20);
+    CHECK(scheduler.stats().stolen > 0);
+}
+
+TEST_CASE("main thread work runs only when the queue is drained")
+{
+    TaskScheduler scheduler(2);
+    std::thread::id main_thread = std::this_thread::get_id();
+    std::atomic<int> ran_on_main(0);
+    for (int i = 0; i < 3; i++)
+    {
+        scheduler.submit([&]
+                         { scheduler.post_to_main_thread([&]
+                                                         { ran_on_main += std::this_thread::get_id() == main_thread; }); });
+    }
+    scheduler.wait_idle();
+    CHECK(ran_on_main == 0);
+
+    CHECK(scheduler.drain_main_thread_queue() == 3);
+    CHECK(ran_on_main == 3);
+    CHECK(scheduler.drain_main_thread_queue() == 0);
+}
+
+TEST_CASE("a throwing task does not stop its worker")
+{
+    TaskScheduler scheduler(1);
+    std::atomic<bool> ran(false);
+    scheduler.submit([] { throw std::runtime_error("failed"); });
+    scheduler.submit([&] { ran = true; });
+    scheduler.wait_idle();
+    CHECK(ran);
+}
+
+TEST_CASE("wait_idle waits for a task submitted just before it")
+{
+    TaskScheduler scheduler(2);
+    for (int i = 0; i < 1000; i++)
+    {
+        std::atomic<bool> ran(false);
+        scheduler.submit([&] { ran = true; });
+        scheduler.wait_idle();
+        REQUIRE(ran);
+    }
+}
+
+TEST_CASE("shutdown waits for running tasks, which can still post to the main thread")
+{
+    TaskScheduler scheduler(2);
+    Gate gate;
+    scheduler.submit([&]
+                     {
+                         gate.task()();
+                         scheduler.post_to_main_thread([] {}); });
+    gate.wait_entered();
+    std::thread opener([&]
+                       {
+                           std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                           gate.open = true; });
+    scheduler.shutdown();
+    opener.join();
+    CHECK(scheduler.stats().executed == 1);
+    CHECK(scheduler.drain_main_thread_queue() == 1);
+}
+
+TEST_CASE("shutdown drops queued tasks and ignores later submits")
+{
+    TaskScheduler scheduler(2);
+    Gate first;
+    Gate second;
+    scheduler.submit(first.task());
+    scheduler.submit(second.task());
+    first.wait_entered();
+    second.wait_entered();
+
+    std::atomic<int> count(0);
+    for (int i = 0; i < 5; i++)
+    {
+        scheduler.submit([&] { count++; });
+    }
+    std::thread opener([&]
+                       {
+                           std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                           first.open = true;
+                           second.open = true; });
+    scheduler.shutdown();
+    opener.join();
+
+    scheduler.submit([&] { count++; });
+    scheduler.wait_idle(); // Returns: nothing is left outstanding
+    CHECK(count == 0);
+    CHECK(scheduler.stats().executed == 2);
+}
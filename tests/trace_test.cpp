@@ -0,0 +1,125 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "../src/trace.h"
+#include "../src/nlohmann/json.hpp"
+#include <fstream>
+#include <string>
+#include <thread>
+
+static const std::string trace_file = "/tmp/just_launch_doom_trace_test.json";
+
+static nlohmann::json read_trace()
+{
+    std::ifstream file(trace_file);
+    return nlohmann::json::parse(file);
+}
+
+static int count_events(const nlohmann::json &trace, const std::string &name)
+{
+    int count = 0;
+    for (const auto &event : trace["traceEvents"])
+    {
+        if (event["name"] == name)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+TEST_CASE("spans are not recorded while tracing is off")
+{
+    {
+        TraceScope scope("ignored");
+    }
+    CHECK_FALSE(is_tracing());
+    CHECK_FALSE(stop_trace());
+}
+
+TEST_CASE("spans from several threads are written as complete events")
+{
+    REQUIRE(start_trace(trace_file));
+    CHECK(is_tracing());
+    set_trace_thread_name("main");
+
+    {
+        TraceScope scope("outer");
+        TraceScope inner("inner");
+    }
+    std::thread worker([]
+                       { TraceScope scope("worker_span"); });
+    worker.join();
+
+    REQUIRE(stop_trace());
+    CHECK_FALSE(is_tracing());
+
+    nlohmann::json trace = read_trace();
+    CHECK(count_events(trace, "outer") == 1);
+    CHECK(count_events(trace, "inner") == 1);
+    CHECK(count_events(trace, "worker_span") == 1);
+    CHECK(count_events(trace, "thread_name") == 1);
+
+    int main_tid = -1;
+    int worker_tid = -1;
+    for (const auto &event : trace["traceEvents"])
+    {
+        if (event["name"] == "outer")
+        {
+            CHECK(event["ph"] == "X");
+            CHECK(event["dur"].get<int64_t>() >= 0);
+            main_tid = event["tid"];
+        }
+        if (event["name"] == "worker_span")
+        {
+            worker_tid = event["tid"];
+        }
+    }
+    CHECK(main_tid != worker_tid);
+}
+
+TEST_CASE("a long-running thread keeps only its most recent spans")
+{
+    REQUIRE(start_trace(trace_file));
+    for (int i = 0; i < 5000; i++)
+    {
+        TraceScope scope("repeated");
+    }
+    record_trace_span("manual", std::chrono::steady_clock::now(), std::chrono::steady_clock::now());
+    REQUIRE(stop_trace());
+
+    nlohmann::json trace = read_trace();
+    CHECK(count_events(trace, "manual") == 1);
+    CHECK(count_events(trace, "repeated") < 5000);
+}
+
+TEST_CASE("a new session exports only its own spans")
+{
+    REQUIRE(start_trace(trace_file));
+    {
+        TraceScope scope("first_session");
+    }
+    std::thread([]
+                { TraceScope scope("first_session_worker"); })
+        .join();
+    REQUIRE(stop_trace());
+
+    REQUIRE(start_trace(trace_file));
+    {
+        TraceScope scope("second_session");
+    }
+    REQUIRE(stop_trace());
+
+    nlohmann::json trace = read_trace();
+    CHECK(count_events(trace, "second_session") == 1);
+    CHECK(count_events(trace, "first_session") == 0);
+    CHECK(count_events(trace, "first_session_worker") == 0);
+    CHECK(count_events(trace, "outer") == 0); // From the earlier test cases
+    CHECK(count_events(trace, "repeated") == 0);
+    for (const auto &event : trace["traceEvents"])
+    {
+        if (event["ph"] == "X")
+        {
+            CHECK(event["ts"].get<int64_t>() >= 0);
+        }
+    }
+}